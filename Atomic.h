@@ -0,0 +1,28 @@
+/************************************************************************
+ * LOGICAL_NAME:    Atomic.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the atomic reads of the counters that the listener
+ * and receive threads update.
+ * 
+ ***/
+
+#ifndef __ATOMIC_H__
+#define __ATOMIC_H__
+
+/**
+ * Reads a 64-bit field that another thread may be updating atomically; a
+ * plain read could be torn on a 32-bit platform (the Makefile builds with
+ * -m32).
+ **/
+template <class T>
+static inline T
+atomicRead(const T &field)
+{
+    return __sync_fetch_and_add(const_cast<T *>(&field), (T)0);
+}
+
+#endif
@@ -0,0 +1,97 @@
+/************************************************************************
+ * LOGICAL_NAME:    CaptureDump.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the 'CaptureDump' tool,
+ * which converts a capture of the MessageBoard into CSV.
+ * 
+ ***/
+
+#include <iostream>
+#include <fstream>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "CaptureLog.h"
+
+using namespace std;
+
+/**
+ * Prints the kept part of the content as a quoted CSV field.
+ **/
+static void
+printPayload(ostream &out, const CaptureRecord &record)
+{
+    DDS::ULong length = record.length < CAPTURE_PAYLOAD ? record.length : CAPTURE_PAYLOAD;
+
+    out << '"';
+    for (DDS::ULong i = 0; i < length; i++) {
+        if (record.payload[i] == '"') {
+            out << '"';
+        }
+        out << record.payload[i];
+    }
+    out << '"';
+}
+
+int
+main (
+    int argc,
+    char *argv[])
+{
+    CaptureReader                   reader;
+    CaptureRecord                   record;
+    const char *                    outputFile = NULL;
+    ofstream                        file;
+    int                             opt;
+
+    /* Options: CaptureDump [-o csvFile] captureFile */
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+        case 'o':
+            outputFile = optarg;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-o csvFile] captureFile" << endl;
+            exit(1);
+        }
+    }
+    if (optind != argc - 1) {
+        cerr << "Usage: " << argv[0] << " [-o csvFile] captureFile" << endl;
+        exit(1);
+    }
+
+    if (!reader.open(argv[optind])) {
+        cerr << argv[optind] << " is not a capture of this version" << endl;
+        exit(1);
+    }
+    if (outputFile) {
+        file.open(outputFile);
+    }
+    ostream &out = outputFile ? file : cout;
+
+    out << "sequence,source_ns,reception_ns,take_ns,latency_ns,user_id,index,publication,length,hash,payload" << endl;
+    for (DDS::ULongLong n = reader.getFirst(); !reader.done(); n++) {
+        if (!reader.read(record)) {
+            cerr << "Error in reading record " << n << " of " << argv[optind] << endl;
+            exit(1);
+        }
+        out << n << ',' << record.sourceTime << ',' << record.receptionTime << ','
+            << record.takeTime << ',' << record.takeTime - record.sourceTime << ','
+            << record.userID << ',' << record.index << ',' << record.publication << ','
+            << record.length << ',' << record.hash << ',';
+        printPayload(out, record);
+        out << endl;
+    }
+
+    cerr << reader.getWritten() - reader.getFirst() << " of " << reader.getWritten()
+         << " records converted" << endl;
+    if (!out) {
+        cerr << "Error in writing " << (outputFile ? outputFile : "the output") << endl;
+        exit(1);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+/************************************************************************
+ * LOGICAL_NAME:    CaptureLog.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the binary capture of the
+ * received ChatMessages.
+ * 
+ ***/
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "CaptureLog.h"
+#include "Timing.h"
+
+using namespace std;
+
+/**
+ * Returns the 32-bit FNV-1a hash of a string, and its length.
+ **/
+static DDS::ULong
+hashContent(const char *content, DDS::ULong &length)
+{
+    DDS::ULong hash = 2166136261U;
+    const char *c;
+
+    for (c = content; *c; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619U;
+    }
+    length = c - content;
+    return hash;
+}
+
+CaptureLog::CaptureLog(const char *fileName, DDS::ULongLong size)
+    : fileName(fileName), written(0)
+{
+    int error;
+
+    /* The reader tool relies on the fixed layout. */
+    if (sizeof(CaptureRecord) != CAPTURE_RECORD_SIZE) {
+        cerr << "Capture records are " << sizeof(CaptureRecord) << " bytes instead of "
+             << CAPTURE_RECORD_SIZE << endl;
+        exit(-1);
+    }
+
+    /* The header takes the first record slot. */
+    capacity = size / CAPTURE_RECORD_SIZE;
+    if (capacity < 2) {
+        cerr << "Capture of " << size << " bytes holds no records" << endl;
+        exit(-1);
+    }
+    capacity--;
+    this->size = (capacity + 1) * CAPTURE_RECORD_SIZE;
+
+    fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cerr << "Error in creating capture " << fileName << ": " << strerror(errno) << endl;
+        exit(-1);
+    }
+
+    /* Allocate all blocks now, so that appending never has to. */
+    error = posix_fallocate(fd, 0, this->size);
+    if (error != 0) {
+        cerr << "Error in allocating capture " << fileName << ": " << strerror(error) << endl;
+        exit(-1);
+    }
+
+    /* Map and fault in all pages now, so that appending never faults. */
+    base = (char *)mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (base == MAP_FAILED) {
+        cerr << "Error in mapping capture " << fileName << ": " << strerror(errno) << endl;
+        exit(-1);
+    }
+
+    header = (CaptureHeader *)base;
+    records = (CaptureRecord *)(base + CAPTURE_RECORD_SIZE);
+    memcpy(header->magic, CAPTURE_MAGIC, sizeof(header->magic));
+    header->version = CAPTURE_VERSION;
+    header->recordSize = CAPTURE_RECORD_SIZE;
+    header->capacity = capacity;
+    header->written = 0;
+}
+
+CaptureLog::~CaptureLog()
+{
+    munmap(base, size);
+    close(fd);
+}
+
+void CaptureLog::append(
+    const DDS::SampleInfo &info,
+    DDS::LongLong takeTime,
+    DDS::Long userID,
+    DDS::Long index,
+    const char *content)
+{
+    CaptureRecord &record = records[written % capacity];
+
+    record.sourceTime = toNanos(info.source_timestamp);
+    record.receptionTime = toNanos(info.reception_timestamp);
+    record.takeTime = takeTime;
+    record.publication = info.publication_handle;
+    record.userID = userID;
+    record.index = index;
+    record.hash = hashContent(content, record.length);
+    strncpy(record.payload, content, CAPTURE_PAYLOAD);
+
+    /* Only count the record once all of it is in place. */
+    __sync_synchronize();
+    header->written = ++written;
+}
+
+void CaptureLog::report(std::ostream &out)
+{
+    out << "Capture: " << written << " records written to " << fileName;
+    if (written > capacity) {
+        out << ", the oldest " << written - capacity << " overwritten";
+    }
+    out << endl;
+}
+
+CaptureReader::CaptureReader() : first(0), next(0)
+{
+    header.capacity = 0;
+    header.written = 0;
+}
+
+bool CaptureReader::open(const char *fileName)
+{
+    in.open(fileName, ios::binary);
+    if (!in.read((char *)&header, sizeof(header)) ||
+        memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CAPTURE_VERSION ||
+        header.recordSize != CAPTURE_RECORD_SIZE ||
+        header.capacity == 0) {
+        return false;
+    }
+    first = header.written >= header.capacity ? header.written - header.capacity + 1 : 0;
+    next = first;
+    return true;
+}
+
+bool CaptureReader::read(CaptureRecord &record)
+{
+    if (done()) {
+        return false;
+    }
+    in.seekg((1 + next % header.capacity) * CAPTURE_RECORD_SIZE);
+    if (!in.read((char *)&record, sizeof(record))) {
+        return false;
+    }
+    next++;
+    return true;
+}
+
+bool CaptureReader::done() const
+{
+    return next >= header.written;
+}
+
+DDS::ULongLong CaptureReader::getFirst() const
+{
+    return first;
+}
+
+DDS::ULongLong CaptureReader::getWritten() const
+{
+    return header.written;
+}
@@ -0,0 +1,126 @@
+/************************************************************************
+ * LOGICAL_NAME:    CaptureLog.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the binary capture of the received
+ * ChatMessages, for the analysis of a run afterwards.
+ * 
+ ***/
+
+#ifndef __CAPTURELOG_H__
+#define __CAPTURELOG_H__
+
+#include <iostream>
+#include <fstream>
+
+#include "ccpp_dds_dcps.h"
+
+#define CAPTURE_MAGIC "CHATCAP"
+#define CAPTURE_VERSION 1
+#define CAPTURE_RECORD_SIZE 128
+#define CAPTURE_PAYLOAD 80          /* bytes of the content kept per record */
+
+/**
+ * One received ChatMessage. All records have the same size, so record n of
+ * a capture is at a fixed offset; the content is kept up to CAPTURE_PAYLOAD
+ * bytes, the hash covers all of it.
+ **/
+struct CaptureRecord {
+    DDS::LongLong                       sourceTime;     /* ns, written by the Chatter */
+    DDS::LongLong                       receptionTime;  /* ns, arrived in the reader */
+    DDS::LongLong                       takeTime;       /* ns, taken by the MessageBoard */
+    DDS::InstanceHandle_t               publication;
+    DDS::Long                           userID;
+    DDS::Long                           index;
+    DDS::ULong                          length;         /* of the whole content */
+    DDS::ULong                          hash;           /* FNV-1a of the whole content */
+    char                                payload[CAPTURE_PAYLOAD];
+};
+
+/**
+ * The first CAPTURE_RECORD_SIZE bytes of a capture file. Records follow it
+ * in a ring of capacity slots: record n is in slot n % capacity, so once
+ * the ring is full the oldest records are overwritten.
+ **/
+struct CaptureHeader {
+    char                                magic[8];
+    DDS::ULong                          version;
+    DDS::ULong                          recordSize;
+    DDS::ULongLong                      capacity;       /* records */
+    DDS::ULongLong                      written;        /* records so far, complete ones only */
+};
+
+/**
+ * Appends CaptureRecords to a memory-mapped file that is allocated and
+ * mapped in full when it is opened. Appending is a copy into memory, with
+ * no system call and no page fault, so it can be done in the take loop;
+ * the kernel writes the pages back. The header is updated after every
+ * record, which keeps the capture readable if the process dies. Not safe
+ * for concurrent appends.
+ **/
+class CaptureLog {
+
+    const char                          *fileName;
+    int                                 fd;
+    char                                *base;
+    DDS::ULongLong                      size;           /* bytes mapped */
+    CaptureHeader                       *header;
+    CaptureRecord                       *records;
+    DDS::ULongLong                      capacity;
+    DDS::ULongLong                      written;
+
+public:
+    /* Constructor: create the file with room for size bytes; exits on failure. */
+    CaptureLog(const char *fileName, DDS::ULongLong size);
+
+    /* Destructor: unmap and close the file. */
+    ~CaptureLog();
+
+    /* Append one received message. */
+    void append(
+        const DDS::SampleInfo &info,
+        DDS::LongLong takeTime,
+        DDS::Long userID,
+        DDS::Long index,
+        const char *content);
+
+    /* Print how many records were written and how many were overwritten. */
+    void report(std::ostream &out);
+};
+
+/**
+ * Reads the records of a capture file, oldest first. Once the ring is
+ * full, the oldest slot is the next to be overwritten and may have been
+ * half overwritten when the writer stopped, so reading starts after it.
+ **/
+class CaptureReader {
+
+    std::ifstream                       in;
+    CaptureHeader                       header;
+    DDS::ULongLong                      first;
+    DDS::ULongLong                      next;
+
+public:
+    /* Constructor */
+    CaptureReader();
+
+    /* Open a capture, returns false if it is not a capture of this version. */
+    bool open(const char *fileName);
+
+    /* Read the next record, returns false at the end or on an error. */
+    bool read(CaptureRecord &record);
+
+    /* Returns whether all records have been read. */
+    bool done() const;
+
+    /* Returns the sequence number of the oldest record that can be read. */
+    DDS::ULongLong getFirst() const;
+
+    /* Returns the number of records written to the capture. */
+    DDS::ULongLong getWritten() const;
+};
+
+#endif
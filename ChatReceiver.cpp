@@ -0,0 +1,529 @@
+/************************************************************************
+ * LOGICAL_NAME:    ChatReceiver.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the receive path of the
+ * MessageBoard.
+ * 
+ ***/
+
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+
+#include "ChatReceiver.h"
+#include "CheckStatus.h"
+#include "Timing.h"
+
+ChatReceiver::ChatReceiver(
+    Chat::ChatMessageDataReader_ptr chatAdmin,
+    Chat::RunControlDataReader_ptr controlAdmin,
+    const ReceiverOptions &options
+) : chatAdmin(chatAdmin), controlAdmin(controlAdmin),
+    maxBatch(options.maxBatch), latencyTarget(options.latencyTarget), batchGrown(0), batchShrunk(0),
+    runTracker(options.drainTimeout, currentTimeNanos()), monitor(*options.monitor), profile("Receive"),
+    received(0), verbose(options.verbose),
+    workCost(options.workCost), pool(NULL), skew(options.skew), capture(options.capture),
+    filter(options.filter), ownID(options.ownID), participant(options.participant),
+    othersQuery(NULL), ownQuery(NULL), filtered(0), ownAnnounced(0),
+    reportPeriod(options.reportPeriod), stats(options.stats)
+{
+    takePhase = profile.addPhase("take");
+    processPhase = profile.addPhase("processing");
+    returnPhase = profile.addPhase("return_loan");
+    startTime = currentTimeNanos();
+    nextReport = startTime + reportPeriod;
+    if (maxBatch <= 0) {
+        batchLimit = DDS::LENGTH_UNLIMITED;
+    } else {
+        batchLimit = maxBatch < BATCH_INITIAL ? maxBatch : BATCH_INITIAL;
+    }
+    if (options.workers > 0) {
+        pool = new WorkerPool(options.workers, options.queueDepth, workCost, completion);
+    }
+    if (filter == FILTER_QUERY) {
+        DDS::StringSeq args;
+        ostringstream numberString;
+
+        numberString << ownID;
+        args.length(1);
+        args[0UL] = numberString.str().c_str();
+
+        /* One condition selects what to process, the other what to throw away. */
+        othersQuery = chatAdmin->create_querycondition( 
+            DDS::ANY_SAMPLE_STATE, 
+            DDS::ANY_VIEW_STATE, 
+            DDS::ANY_INSTANCE_STATE, 
+            "userID <> %0", 
+            args);
+        checkHandle(othersQuery, "DDS::DataReader::create_querycondition (others)");
+        ownQuery = chatAdmin->create_querycondition( 
+            DDS::ANY_SAMPLE_STATE, 
+            DDS::ANY_VIEW_STATE, 
+            DDS::ANY_INSTANCE_STATE, 
+            "userID = %0", 
+            args);
+        checkHandle(ownQuery, "DDS::DataReader::create_querycondition (own)");
+    }
+    pthread_mutex_init(&lock, NULL);
+    cpuStart = processCpuNanos();
+}
+
+ChatReceiver::~ChatReceiver()
+{
+    delete pool;
+    pthread_mutex_destroy(&lock);
+}
+
+DDS::ULong ChatReceiver::takeMessages()
+{
+    DDS::ULong total = 0;
+    DDS::ULong taken;
+    DDS::Long limit;
+
+    pthread_mutex_lock(&lock);
+
+    /* A full batch means more may be waiting: neither a listener nor a
+       ReadCondition would notice those again until new data arrives. */
+    do {
+        limit = batchLimit;
+        taken = takeBatch();
+        total += taken;
+    } while (limit != DDS::LENGTH_UNLIMITED && taken == (DDS::ULong)limit);
+
+    if (ownQuery) {
+        discardOwn();
+    }
+
+    pthread_mutex_unlock(&lock);
+    return total;
+}
+
+void ChatReceiver::discardOwn()
+{
+    DDS::ReturnCode_t status;
+
+    /* Left in the reader, they would keep waking up the receive loop. */
+    status = chatAdmin->take_w_condition( 
+        msgSeq, 
+        infoSeq, 
+        DDS::LENGTH_UNLIMITED, 
+        ownQuery);
+    checkStatus(status, "Chat::ChatMessageDataReader::take_w_condition (own)");
+    for (DDS::ULong i = 0; i < msgSeq.length(); i++) {
+        if (infoSeq[i].valid_data) {
+            filtered++;
+        }
+    }
+    status = chatAdmin->return_loan(msgSeq, infoSeq);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+}
+
+bool ChatReceiver::filteredOut(const Chat::ChatMessage &message, const DDS::SampleInfo &info)
+{
+    DDS::InstanceHandle_t publication = info.publication_handle;
+
+    if ((filter != FILTER_APP && filter != FILTER_IGNORE) || message.userID != ownID) {
+        return false;
+    }
+    /* Ask the middleware to stop delivering from this writer at all; only
+       a valid sample is sure to carry the userID of its writer. */
+    if (filter == FILTER_IGNORE && info.valid_data && ignored.find(publication) == ignored.end()) {
+        DDS::ReturnCode_t status = participant->ignore_publication(publication);
+        checkStatus(status, "DDS::DomainParticipant::ignore_publication");
+        ignored.insert(publication);
+    }
+    return true;
+}
+
+DDS::ULong ChatReceiver::takeBatch()
+{
+    DDS::ReturnCode_t status;
+    DDS::ULong taken = 0;
+    DDS::ULong valid = 0;
+    DDS::ULongLong payload = 0;
+    DDS::LongLong start = currentTimeNanos();
+    DDS::ULongLong takeStart = readCycles();
+    DDS::ULongLong processStart;
+    DDS::ULongLong returnStart;
+
+    /* Note: using read does not remove the samples from
+       unregistered instances from the DataReader. This means
+       that the DataRase would use more and more resources.
+       That's why we use take here instead. Messages of instances
+       that were disposed already are still taken, since they belong
+       to the run that has just ended. */
+    if (othersQuery) {
+        status = chatAdmin->take_w_condition( 
+            msgSeq, 
+            infoSeq, 
+            batchLimit, 
+            othersQuery);
+        checkStatus(status, "Chat::ChatMessageDataReader::take_w_condition");
+    } else {
+        status = chatAdmin->take( 
+            msgSeq, 
+            infoSeq, 
+            batchLimit, 
+            DDS::ANY_SAMPLE_STATE, 
+            DDS::ANY_VIEW_STATE, 
+            DDS::ANY_INSTANCE_STATE );
+        checkStatus(status, "Chat::ChatMessageDataReader::take");
+    }
+    if (status == DDS::RETCODE_NO_DATA) {
+        profile.record(takePhase, readCycles() - takeStart, 0);
+        return 0;
+    }
+    taken = msgSeq.length();
+    processStart = readCycles();
+    profile.record(takePhase, processStart - takeStart, taken);
+
+    /* All messages of one take arrived at the same moment. */
+    DDS::LongLong now = currentTimeNanos();
+
+    for (DDS::ULong i = 0; i < taken; i++) {
+        if (filteredOut(msgSeq[i], infoSeq[i])) {
+            if (infoSeq[i].valid_data) {
+                filtered++;
+            }
+        } else if (infoSeq[i].valid_data) {
+            latency.record(now - toNanos(infoSeq[i].source_timestamp));
+            runTracker.received(msgSeq[i].userID, now);
+            if (verbose) {
+                cout << msgSeq[i].content << endl;
+            }
+            sequenceTracker.received(msgSeq[i].userID, infoSeq[i].publication_handle, msgSeq[i].index);
+            if (skew) {
+                skew->arrived(infoSeq[i].publication_handle, msgSeq[i].userID, msgSeq[i].index, now);
+            }
+            if (capture) {
+                capture->append(infoSeq[i], now, msgSeq[i].userID, msgSeq[i].index, msgSeq[i].content);
+            }
+            payload += strlen(msgSeq[i].content);
+            valid++;
+
+            if (pool) {
+                /* Copy, so the loan does not have to wait for the workers. */
+                WorkItem item;
+                item.userID = msgSeq[i].userID;
+                item.index = msgSeq[i].index;
+                item.sourceTime = toNanos(infoSeq[i].source_timestamp);
+                item.content = msgSeq[i].content.in();
+                pool->submit(item);
+            } else if (workCost > 0) {
+                spinNanos(workCost);
+                completion.record(currentTimeNanos() - toNanos(infoSeq[i].source_timestamp));
+            }
+        } else {
+            /* No message, only the news that the instance was disposed or unregistered. */
+            sequenceTracker.notification(infoSeq[i].instance_state);
+        }
+    }
+
+    /* Hand the loan back before anything else. */
+    returnStart = readCycles();
+    profile.record(processPhase, returnStart - processStart, taken);
+    status = chatAdmin->return_loan(msgSeq, infoSeq);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+    profile.record(returnPhase, readCycles() - returnStart, taken);
+    if (pool) {
+        pool->flush();
+    }
+
+    received += valid;
+    meter.record(valid, payload);
+
+    batchSizes.record(taken);
+    adaptBatch(taken, currentTimeNanos() - start);
+
+    return taken;
+}
+
+void ChatReceiver::adaptBatch(DDS::ULong taken, DDS::LongLong processingTime)
+{
+    if (batchLimit == DDS::LENGTH_UNLIMITED) {
+        return;
+    }
+    if (processingTime > latencyTarget && batchLimit > BATCH_MIN) {
+        /* The last sample of the batch waited too long: take less at once. */
+        batchLimit /= 2;
+        if (batchLimit < BATCH_MIN) {
+            batchLimit = BATCH_MIN;
+        }
+        batchShrunk++;
+    } else if (taken == (DDS::ULong)batchLimit && processingTime < latencyTarget / 2 && batchLimit < maxBatch) {
+        /* There is a backlog and room within the target: take more at once. */
+        batchLimit *= 2;
+        if (batchLimit > maxBatch) {
+            batchLimit = maxBatch;
+        }
+        batchGrown++;
+    }
+}
+
+void ChatReceiver::takeAnnouncements()
+{
+    DDS::ReturnCode_t status;
+
+    pthread_mutex_lock(&lock);
+
+    status = controlAdmin->take( 
+        controlSeq, 
+        controlInfoSeq, 
+        DDS::LENGTH_UNLIMITED, 
+        DDS::ANY_SAMPLE_STATE, 
+        DDS::ANY_VIEW_STATE, 
+        DDS::ANY_INSTANCE_STATE );
+    checkStatus(status, "Chat::RunControlDataReader::take");
+
+    for (DDS::ULong i = 0; i < controlSeq.length(); i++) {
+        if (!controlInfoSeq[i].valid_data) {
+            continue;
+        }
+        if (filter != FILTER_NONE && controlSeq[i].userID == ownID) {
+            /* Never delivered, so not waited for; its size tells the selectivity. */
+            if (controlSeq[i].kind == Chat::RUN_END &&
+                toNanos(controlInfoSeq[i].source_timestamp) >= startTime) {
+                ownAnnounced += controlSeq[i].sentCount;
+            }
+            continue;
+        }
+        runTracker.control(controlSeq[i], controlInfoSeq[i], currentTimeNanos());
+    }
+
+    status = controlAdmin->return_loan(controlSeq, controlInfoSeq);
+    checkStatus(status, "Chat::RunControlDataReader::return_loan");
+
+    pthread_mutex_unlock(&lock);
+}
+
+bool ChatReceiver::drained()
+{
+    pthread_mutex_lock(&lock);
+    bool result = runTracker.drained(currentTimeNanos());
+    if (result && pool) {
+        result = pool->idle();
+    }
+    pthread_mutex_unlock(&lock);
+
+    return result;
+}
+
+void ChatReceiver::finish()
+{
+    DDS::ReturnCode_t status;
+
+    pthread_mutex_lock(&lock);
+    if (pool) {
+        pool->stop();
+    }
+    if (othersQuery) {
+        status = chatAdmin->delete_readcondition(othersQuery);
+        checkStatus(status, "DDS::DataReader::delete_readcondition (others)");
+        status = chatAdmin->delete_readcondition(ownQuery);
+        checkStatus(status, "DDS::DataReader::delete_readcondition (own)");
+        othersQuery = NULL;
+        ownQuery = NULL;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void ChatReceiver::addProfile(CycleProfile &other)
+{
+    otherProfiles.push_back(&other);
+}
+
+void ChatReceiver::tick()
+{
+    DDS::LongLong now = currentTimeNanos();
+
+    if (reportPeriod <= 0 || now < nextReport) {
+        return;
+    }
+    nextReport += reportPeriod;
+    if (nextReport <= now) {
+        nextReport = now + reportPeriod;
+    }
+
+    /* Without a new interval the meter would hand out the previous one again. */
+    bool interval = meter.report(cout);
+    monitor.report(cout);
+
+    /* No lock: the snapshot reads the counters atomically while the receive thread records. */
+    latency.snapshot(latencyInterval);
+    cout << "[" << fixed << setprecision(1) << nanosToSeconds(now - startTime) << " s] latency (us) total: ";
+    latencyInterval.print(cout, 1000.0);
+    cout << endl;
+
+    latencyInterval.subtract(latencyReported);
+    cout << "[" << fixed << setprecision(1) << nanosToSeconds(now - startTime) << " s] latency (us) interval: ";
+    latencyInterval.print(cout, 1000.0);
+    cout << endl;
+
+    /* What was reported before plus this interval is what has been reported now. */
+    latencyReported.merge(latencyInterval);
+
+    ostringstream prefix;
+    prefix << "[" << fixed << setprecision(1) << nanosToSeconds(now - startTime) << " s] ";
+    profile.reportInterval(cout, prefix.str().c_str());
+    for (DDS::ULong i = 0; i < otherProfiles.size(); i++) {
+        otherProfiles[i]->reportInterval(cout, prefix.str().c_str());
+    }
+
+    if (stats && interval) {
+        DDS::ULongLong lost;
+        DDS::ULongLong duplicates;
+        DDS::ULongLong reordered;
+
+        /* The tracker is only consistent under the lock, e.g. with a listener thread. */
+        pthread_mutex_lock(&lock);
+        sequenceTracker.getTotals(lost, duplicates, reordered);
+        pthread_mutex_unlock(&lock);
+
+        stats->begin("interval");
+        stats->integer("samples", meter.getIntervalSamples());
+        stats->number("samples_per_s", meter.getIntervalRate());
+        stats->number("bytes_per_s", meter.getIntervalByteRate());
+        stats->histogram("latency_us", latencyInterval, 1000.0);
+        stats->integer("lost", lost);
+        stats->integer("duplicates", duplicates);
+        stats->integer("reordered", reordered);
+        stats->statuses(monitor);
+        stats->end();
+    }
+}
+
+void ChatReceiver::report(std::ostream &out)
+{
+    pthread_mutex_lock(&lock);
+
+    runTracker.report(out);
+    sequenceTracker.report(out);
+    meter.summary(out);
+    monitor.report(out);
+
+    /* How many own messages there were, and how many the application still saw. */
+    if (filter != FILTER_NONE) {
+        static const char *names[] = { "none", "cft", "query", "ignore", "app" };
+        static const char *seen[] = {
+            "reached the application",
+            "reached the application",
+            "were taken only to be discarded",
+            "reached the application before their publication was ignored",
+            "were dropped by the application"
+        };
+
+        out << "Filter (" << names[filter] << ", userID <> " << ownID << "): "
+            << ownAnnounced << " own messages announced, " << filtered
+            << " " << seen[filter];
+        if (ownAnnounced + received > 0) {
+            out << ", selectivity " << fixed << setprecision(3)
+                << (double)received / (ownAnnounced + received);
+        }
+        if (filter == FILTER_IGNORE) {
+            out << ", " << ignored.size() << " publications ignored";
+        }
+        out << endl;
+    }
+
+    if (capture) {
+        capture->report(out);
+    }
+
+    /* Latency from writing a message until taking it, in microseconds. */
+    out << "Latency (us): ";
+    latency.print(out, 1000.0);
+    out << endl;
+
+    /* Latency from writing a message until it has been processed, in microseconds. */
+    if (pool || workCost > 0) {
+        if (pool) {
+            pool->report(out);
+        }
+        out << "Completion latency (us): ";
+        completion.print(out, 1000.0);
+        out << endl;
+    }
+
+    /* Samples per take, and how the batch limit moved. */
+    out << "Batch size: ";
+    batchSizes.print(out, 1.0);
+    out << endl;
+    if (batchLimit != DDS::LENGTH_UNLIMITED) {
+        out << "Batch limit: final " << batchLimit << " (max " << maxBatch << "), grown "
+            << batchGrown << " times, shrunk " << batchShrunk << " times" << endl;
+    }
+
+    /* Cycles of the application itself, apart from the middleware threads. */
+    profile.report(out);
+    for (DDS::ULong i = 0; i < otherProfiles.size(); i++) {
+        otherProfiles[i]->report(out);
+    }
+
+    /* CPU time of the whole process, including the middleware threads. */
+    DDS::LongLong cpuUsed = processCpuNanos() - cpuStart;
+    out << "CPU time: " << fixed << setprecision(3) << nanosToSeconds(cpuUsed) << " s";
+    if (received > 0) {
+        out << ", " << setprecision(1) << (double)cpuUsed / received << " ns per sample";
+    }
+    out << endl;
+
+    if (stats) {
+        DDS::ULongLong lost;
+        DDS::ULongLong duplicates;
+        DDS::ULongLong reordered;
+
+        sequenceTracker.getTotals(lost, duplicates, reordered);
+        stats->begin("summary");
+        stats->integer("samples", meter.getSamples());
+        stats->integer("bytes", meter.getBytes());
+        stats->number("samples_per_s", meter.getRate());
+        stats->number("bytes_per_s", meter.getByteRate());
+        stats->number("rate_cv", meter.getRateVariation());
+        stats->histogram("latency_us", latency, 1000.0);
+        if (pool || workCost > 0) {
+            stats->histogram("completion_us", completion, 1000.0);
+        }
+        stats->histogram("batch_size", batchSizes, 1.0);
+        stats->integer("lost", lost);
+        stats->integer("duplicates", duplicates);
+        stats->integer("reordered", reordered);
+        stats->statuses(monitor);
+        if (filter != FILTER_NONE) {
+            stats->integer("filtered", filtered);
+        }
+        stats->number("cpu_ns_per_sample", received > 0 ? (double)cpuUsed / received : 0.0);
+        stats->end();
+    }
+
+    pthread_mutex_unlock(&lock);
+}
+
+const Histogram &ChatReceiver::getLatency() const
+{
+    return latency;
+}
+
+void ChatReceiver::saveLatency(std::ostream &out)
+{
+    latency.serialize(out);
+}
+
+ChatReceiverListener::ChatReceiverListener(
+    ChatReceiver &receiver,
+    bool announcements,
+    StatusMonitor &monitor
+) : StatusReaderListener(monitor), receiver(receiver), announcements(announcements) { }
+
+void ChatReceiverListener::on_data_available (
+    DDS::DataReader_ptr reader
+) THROW_ORB_EXCEPTIONS {
+    if (announcements) {
+        receiver.takeAnnouncements();
+    } else {
+        receiver.takeMessages();
+    }
+}
@@ -0,0 +1,214 @@
+/************************************************************************
+ * LOGICAL_NAME:    ChatReceiver.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the receive path of the MessageBoard,
+ * shared by all of its receive modes.
+ * 
+ ***/
+
+#ifndef __CHATRECEIVER_H__
+#define __CHATRECEIVER_H__
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <pthread.h>
+
+#include "ccpp_dds_dcps.h"
+#include "ccpp_Chat.h"
+#include "orb_abstraction.h"
+#include "RunControl.h"
+#include "Histogram.h"
+#include "StatusMonitor.h"
+#include "CycleProfile.h"
+#include "SequenceTracker.h"
+#include "ThroughputMeter.h"
+#include "WorkerPool.h"
+#include "FanOut.h"
+#include "CaptureLog.h"
+#include "StatsEmitter.h"
+
+/**
+ * Bounds for the number of samples taken at once. The batch size adapts
+ * between the minimum and the configured maximum: it grows while a backlog
+ * is processed well within the latency target and shrinks when processing
+ * a batch exceeds it.
+ **/
+#define BATCH_MIN 1
+#define BATCH_INITIAL 32
+
+/**
+ * Where the messages of ownID are filtered out: by a ContentFilteredTopic
+ * in the middleware, by a QueryCondition when taking, by ignoring the
+ * publications they come from, or by the application after taking them.
+ **/
+enum FilterKind {
+    FILTER_NONE,
+    FILTER_CFT,
+    FILTER_QUERY,
+    FILTER_IGNORE,
+    FILTER_APP
+};
+
+/**
+ * Settings of the receive path, taken from the MessageBoard options.
+ **/
+struct ReceiverOptions {
+    DDS::LongLong                       drainTimeout;   /* ns */
+    DDS::Long                           maxBatch;       /* 0 means unlimited */
+    DDS::LongLong                       latencyTarget;  /* ns */
+    DDS::LongLong                       reportPeriod;   /* ns, 0 means only at the end */
+    bool                                verbose;        /* print every message */
+    DDS::ULong                          workers;        /* 0 processes in the take thread */
+    DDS::ULong                          queueDepth;     /* items a worker may hold */
+    DDS::LongLong                       workCost;       /* ns of synthetic work per message */
+    ArrivalSkew                         *skew;          /* NULL without additional readers */
+    StatusMonitor                       *monitor;       /* statuses of the readers */
+    FilterKind                          filter;
+    DDS::Long                           ownID;          /* messages to filter out */
+    DDS::DomainParticipant_ptr          participant;    /* for FILTER_IGNORE, with one plain reader */
+    CaptureLog                          *capture;       /* NULL without capture */
+    StatsEmitter                        *stats;         /* NULL without JSON statistics */
+};
+
+class ChatReceiver {
+
+    /* Readers (owned by the MessageBoard). */
+    Chat::ChatMessageDataReader_ptr     chatAdmin;
+    Chat::RunControlDataReader_ptr      controlAdmin;
+
+    /* Sequences that receive the loans, allocated only once. */
+    Chat::ChatMessageSeq                msgSeq;
+    DDS::SampleInfoSeq                  infoSeq;
+    Chat::RunControlSeq                 controlSeq;
+    DDS::SampleInfoSeq                  controlInfoSeq;
+
+    /* Adaptive batch size (maxBatch 0 means unlimited). */
+    DDS::Long                           maxBatch;
+    DDS::Long                           batchLimit;
+    DDS::LongLong                       latencyTarget;
+    DDS::ULong                          batchGrown;
+    DDS::ULong                          batchShrunk;
+
+    /* Run bookkeeping and statistics. */
+    RunTracker                          runTracker;
+    SequenceTracker                     sequenceTracker;
+    Histogram                           latency;
+    Histogram                           batchSizes;
+    ThroughputMeter                     meter;
+    StatusMonitor                       &monitor;
+
+    /* Cycles per sample spent in take, the processing loop and return_loan. */
+    CycleProfile                        profile;
+    DDS::ULong                          takePhase;
+    DDS::ULong                          processPhase;
+    DDS::ULong                          returnPhase;
+    std::vector<CycleProfile *>         otherProfiles;
+    DDS::LongLong                       received;
+    DDS::LongLong                       cpuStart;
+    bool                                verbose;
+
+    /* Processing of the messages, in the take thread or by a pool of workers. */
+    DDS::LongLong                       workCost;
+    WorkerPool                          *pool;
+    Histogram                           completion;
+    ArrivalSkew                         *skew;
+    CaptureLog                          *capture;
+
+    /* Filtering of the own messages. */
+    FilterKind                          filter;
+    DDS::Long                           ownID;
+    DDS::DomainParticipant_ptr          participant;
+    DDS::QueryCondition_ptr             othersQuery;    /* FILTER_QUERY: what to take */
+    DDS::QueryCondition_ptr             ownQuery;       /* FILTER_QUERY: what to discard */
+    std::set<DDS::InstanceHandle_t>     ignored;        /* FILTER_IGNORE: publications ignored */
+    DDS::ULongLong                      filtered;       /* own messages seen by the application */
+    DDS::LongLong                       ownAnnounced;   /* own messages the runs announced */
+
+    /* Periodic reporting: the interval is the difference with the previous snapshot. */
+    DDS::LongLong                       reportPeriod;
+    DDS::LongLong                       startTime;
+    DDS::LongLong                       nextReport;
+    Histogram                           latencyReported;
+    Histogram                           latencyInterval;
+    StatsEmitter                        *stats;
+
+    /* Listener threads and the main thread may use the receiver concurrently. */
+    pthread_mutex_t                     lock;
+
+    /* Take and process one batch, returns the number of samples taken. */
+    DDS::ULong takeBatch();
+
+    /* Take and drop the own messages a QueryCondition left behind in the reader. */
+    void discardOwn();
+
+    /* Returns whether a sample has to be filtered out here. */
+    bool filteredOut(const Chat::ChatMessage &message, const DDS::SampleInfo &info);
+
+    /* Adapt the batch limit to the size and processing time of the last batch. */
+    void adaptBatch(DDS::ULong taken, DDS::LongLong processingTime);
+
+public:
+    /* Constructor */
+    ChatReceiver(
+        Chat::ChatMessageDataReader_ptr chatAdmin,
+        Chat::RunControlDataReader_ptr controlAdmin,
+        const ReceiverOptions &options);
+
+    /* Destructor */
+    ~ChatReceiver();
+
+    /* Take and process all available ChatMessages in bounded batches, returns the number of messages. */
+    DDS::ULong takeMessages();
+
+    /* Take and process all available RunControl announcements. */
+    void takeAnnouncements();
+
+    /* Returns whether all announced runs have ended and drained, and the workers processed everything. */
+    bool drained();
+
+    /* Wait until the workers have processed all messages taken so far and
+       delete the conditions on the reader; call before deleting the readers. */
+    void finish();
+
+    /* Include another receive path in the cycle profile reports. */
+    void addProfile(CycleProfile &other);
+
+    /* Print the interval throughput, statuses, latencies and cycles when a report is due; called by the receive loops. */
+    void tick();
+
+    /* Print the statistics of the run(s), and emit them as a summary record. */
+    void report(std::ostream &out);
+
+    /* Returns the latency from writing a message until taking it. */
+    const Histogram &getLatency() const;
+
+    /* Write the cumulative latency histogram, to be merged with those of other runs. */
+    void saveLatency(std::ostream &out);
+};
+
+/**
+ * DataReaderListener that lets the ChatReceiver take the data as soon as it
+ * is available, either the messages or the announcements, and counts the
+ * monitored statuses of the reader.
+ **/
+class ChatReceiverListener : public StatusReaderListener {
+
+    ChatReceiver                        &receiver;
+    bool                                announcements;
+
+public:
+    /* Constructor */
+    ChatReceiverListener(ChatReceiver &receiver, bool announcements, StatusMonitor &monitor);
+
+    /* Callback method implementation. */
+    virtual void on_data_available (
+        DDS::DataReader_ptr reader
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+#endif
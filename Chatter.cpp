@@ -25,14 +25,20 @@
 #include <iostream>
 #include <unistd.h>
 #include <iomanip>
+#include <stdlib.h>
 
 #include "ccpp_dds_dcps.h"
 #include "CheckStatus.h"
 #include "ccpp_Chat.h"
+#include "RunControl.h"
+#include "StatusMonitor.h"
+#include "Histogram.h"
+#include "Replay.h"
+#include "Timing.h"
+#include "StatsEmitter.h"
 
 #define MAX_MSG_LEN 256
 #define NUM_MSG 60
-#define TERMINATION_MESSAGE -1 
 
 using namespace DDS;
 using namespace Chat;
@@ -41,6 +47,16 @@ void printTopicQos(DDS::TopicQos topicQos);
 void printReaderQos(DDS::DataReaderQos readerQos);
 void printWriterQos(DDS::DataWriterQos readerQos);
 void printCurrentTime(DDS::DomainParticipant &participant);
+LongLong replayMessages(
+    Replay &replay,
+    ChatMessageDataWriter_ptr talker,
+    NameServiceDataWriter_ptr nameServer,
+    RunControlDataWriter_ptr runAnnouncer,
+    Long firstID,
+    double speed,
+    double joinRate,
+    ULong configHash,
+    Histogram &lag);
 
 int 
 main (
@@ -52,6 +68,7 @@ main (
     DomainParticipant_var           participant;
     Topic_var                       chatMessageTopic;
     Topic_var                       nameServiceTopic;
+    Topic_var                       runControlTopic;
     Publisher_var                   chatPublisher;
     DataWriter_ptr                  parentWriter;
 
@@ -71,10 +88,12 @@ main (
     NameServiceTypeSupport_var      nameServiceTS;
     ChatMessageDataWriter_var       talker;
     NameServiceDataWriter_var       nameServer;
+    RunControlDataWriter_var        runAnnouncer;
 
     /* Sample definitions */
-    ChatMessage                     *msg;   /* Example on Heap */
+    ChatMessage                     *msg = NULL;    /* Example on Heap */
     NameService                     ns;     /* Example on Stack */
+    RunControl                      announcement;
     
     /* Others */
     int                             ownID = 1;
@@ -83,24 +102,63 @@ main (
     const char                      *partitionName = "ChatRoom";
     char                            *chatMessageTypeName = NULL;
     char                            *nameServiceTypeName = NULL;
+    LongLong                        sentCount = 0;
     ostringstream                   buf;
+    StatusMonitor                   monitor;
+    StatusWriterListener            *writerStatus;
+    const char                      *replayFile = NULL;
+    double                          speed = 1.0;
+    double                          joinRate = 0.0;
+    Replay                          *replay = NULL;
+    Histogram                       lag;
+    const char                      *statsTarget = NULL;
+    StatsEmitter                    *stats = NULL;
+    LongLong                        startTime;
+    int                             opt;
 
 #ifdef INTEGRITY
-#ifdef CHATTER_QUIT
-    ownID = -1;
-#else
     ownID = 1;
-#endif
     chatterName = "dds_user";
 #else
-    /* Options: Chatter [ownID [name]] */
-    if (argc > 1) {
-        istringstream args(argv[1]);
+    /* Options: Chatter [-p replayFile] [-x speed] [-j joinRate] [-J statsFile|fd:N] [ownID [name]] */
+    /* With -p the messages of a capture or CSV file are replayed, as userIDs
+       ownID, ownID + 1, ... for the users in it, at speed times the original
+       rate; a speed of 0 replays them as fast as possible. The users join
+       at joinRate per second, or all at once when it is 0. */
+    /* With -J a summary of the run is also written as a JSON line, to a file
+       or an open file descriptor. */
+    while ((opt = getopt(argc, argv, "p:x:j:J:")) != -1) {
+        switch (opt) {
+        case 'p':
+            replayFile = optarg;
+            break;
+        case 'x':
+            speed = atof(optarg);
+            break;
+        case 'j':
+            joinRate = atof(optarg);
+            break;
+        case 'J':
+            statsTarget = optarg;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-p replayFile] [-x speed] [-j joinRate] [-J statsFile|fd:N] [ownID [name]]" << endl;
+            exit(1);
+        }
+    }
+    if (optind < argc) {
+        istringstream args(argv[optind]);
         args >> ownID;
-        if (argc > 2) {
-            chatterName = argv[2];
+        if (optind + 1 < argc) {
+            chatterName = argv[optind + 1];
         }
     }
+    if (replayFile) {
+        replay = new Replay(replayFile);
+    }
+    if (statsTarget) {
+        stats = new StatsEmitter(statsTarget, "Chatter");
+    }
 #endif
 
     /* Create a DomainParticipantFactory and a DomainParticipant (using Default QoS settings. */
@@ -173,11 +231,15 @@ main (
     checkHandle(chatPublisher.in(), "DDS::DomainParticipant::create_publisher");
     
     /* Create a DataWriter for the ChatMessage Topic (using the appropriate QoS). */
+    /* All DataWriters count lost liveliness, missed deadlines and incompatible QoS. */
+    writerStatus = new StatusWriterListener(monitor);
+    checkHandle(writerStatus, "new StatusWriterListener");
+
     parentWriter = chatPublisher->create_datawriter(
         chatMessageTopic.in(), 
         DATAWRITER_QOS_USE_TOPIC_QOS,
-        NULL,
-        STATUS_MASK_NONE);
+        writerStatus,
+        MONITORED_WRITER_STATUS);
     checkHandle(parentWriter, "DDS::Publisher::create_datawriter (chatMessage)");
     
     /* Narrow the abstract parent into its typed representative. */
@@ -193,8 +255,8 @@ main (
     parentWriter = chatPublisher->create_datawriter( 
         nameServiceTopic.in(), 
         dw_qos, 
-        NULL,
-        STATUS_MASK_NONE);
+        writerStatus,
+        MONITORED_WRITER_STATUS);
     checkHandle(parentWriter, "DDS::Publisher::create_datawriter (NameService)");
     cout << "Data Writer QOS: " << endl;
     printWriterQos(dw_qos);
@@ -203,68 +265,150 @@ main (
     nameServer = NameServiceDataWriter::_narrow(parentWriter);
     checkHandle(nameServer.in(), "Chat::NameServiceDataWriter::_narrow");
     
-    /* Initialize the NameServer attributes located on stack. */
-    ns.userID = ownID;
-    if (chatterName) {
-        ns.name = string_dup(chatterName);
-    } else {
-        buf << "Chatter " << ownID;
-        ns.name = string_dup( buf.str().c_str() );
-    }
-
-    /* Write the user-information into the system (registering the instance implicitly). */
-    status = nameServer->write(ns, HANDLE_NIL);
-    checkStatus(status, "Chat::ChatMessageDataWriter::write");
-    
-    /* Initialize the chat messages on Heap. */
-    msg = new ChatMessage();
-    checkHandle(msg, "new ChatMessage");
-    msg->userID = ownID;
-    msg->index = 0;
-    buf.str( string("") );
-    if (ownID == TERMINATION_MESSAGE) {
-        buf << "Termination message.";
-    } else { 
-        buf << "Hi there, I will send you " << NUM_MSG << " more messages.";
-    }
-    msg->content = string_dup( buf.str().c_str() );
-    cout << "Writing message: \"" << msg->content  << "\"" << endl;
+    /* Create the RunControl Topic on which this run is announced. */
+    runControlTopic = createRunControlTopic(participant.in());
 
-    /* Register a chat message for this user (pre-allocating resources for it!!) */
-    userHandle = talker->register_instance(*msg);
+    /* Create a DataWriter for the RunControl Topic; the announcements are only disposed at the end of the run. */
+    status = chatPublisher->get_default_datawriter_qos(dw_qos);
+    checkStatus(status, "DDS::Publisher::get_default_datawriter_qos");
+    status = runControlTopic->get_qos(setting_topic_qos);
+    checkStatus(status, "DDS::Topic::get_qos");
+    status = chatPublisher->copy_from_topic_qos(dw_qos, setting_topic_qos);
+    checkStatus(status, "DDS::Publisher::copy_from_topic_qos");
+    dw_qos.writer_data_lifecycle.autodispose_unregistered_instances = FALSE;
+    parentWriter = chatPublisher->create_datawriter( 
+        runControlTopic.in(), 
+        dw_qos, 
+        writerStatus,
+        MONITORED_WRITER_STATUS);
+    checkHandle(parentWriter, "DDS::Publisher::create_datawriter (RunControl)");
 
-    /* Write a message using the pre-generated instance handle. */
-    status = talker->write(*msg, userHandle);
-    checkStatus(status, "Chat::ChatMessageDataWriter::write");
+    /* Narrow the abstract parent into its typed representative. */
+    runAnnouncer = RunControlDataWriter::_narrow(parentWriter);
+    checkHandle(runAnnouncer.in(), "Chat::RunControlDataWriter::_narrow");
+
+    startTime = currentTimeNanos();
+    if (replay) {
+        /* Replay the traffic of the capture instead of chatting. */
+        buf << "reliability=" << (reliable_topic_qos.reliability.kind == RELIABLE_RELIABILITY_QOS ? "RELIABLE" : "BEST_EFFORT")
+            << ";replay=" << replayFile
+            << ";speed=" << speed
+            << ";joinRate=" << joinRate
+            << ";partition=" << partitionName;
+        sentCount = replayMessages(
+            *replay, 
+            talker.in(), 
+            nameServer.in(), 
+            runAnnouncer.in(), 
+            ownID, 
+            speed, 
+            joinRate,
+            hashConfiguration(buf.str().c_str()),
+            lag);
+    } else {
+        /* Initialize the NameServer attributes located on stack. */
+        ns.userID = ownID;
+        if (chatterName) {
+            ns.name = string_dup(chatterName);
+        } else {
+            buf << "Chatter " << ownID;
+            ns.name = string_dup( buf.str().c_str() );
+        }
 
-    sleep (1); /* do not run so fast! */
- 
-    /* Write any number of messages, re-using the existing string-buffer: no leak!!. */
-    for (i = 1; i <= NUM_MSG && ownID != TERMINATION_MESSAGE; i++) {
-        printCurrentTime(*participant);
+        /* Write the user-information into the system (registering the instance implicitly). */
+        status = nameServer->write(ns, HANDLE_NIL);
+        checkStatus(status, "Chat::ChatMessageDataWriter::write");
 
+        /* Announce the start of the run, identifying the configuration it uses. */
+        buf.str( string("") );
+        buf << "reliability=" << (reliable_topic_qos.reliability.kind == RELIABLE_RELIABILITY_QOS ? "RELIABLE" : "BEST_EFFORT")
+            << ";messages=" << NUM_MSG
+            << ";partition=" << partitionName;
+        announcement.userID = ownID;
+        announcement.kind = RUN_START;
+        announcement.sentCount = 0;
+        announcement.configHash = hashConfiguration(buf.str().c_str());
+        status = runAnnouncer->write(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::write (RUN_START)");
+    
+        /* Initialize the chat messages on Heap. */
+        msg = new ChatMessage();
+        checkHandle(msg, "new ChatMessage");
+        msg->userID = ownID;
+        msg->index = 0;
         buf.str( string("") );
-        msg->index = i;
-        buf << "Message no. " << i;
+        buf << "Hi there, I will send you " << NUM_MSG << " more messages.";
         msg->content = string_dup( buf.str().c_str() );
-        cout << "Writing message: \"" << msg->content << "\"" << endl;
+        cout << "Writing message: \"" << msg->content  << "\"" << endl;
+
+        /* Register a chat message for this user (pre-allocating resources for it!!) */
+        userHandle = talker->register_instance(*msg);
+
+        /* Write a message using the pre-generated instance handle. */
         status = talker->write(*msg, userHandle);
         checkStatus(status, "Chat::ChatMessageDataWriter::write");
+        sentCount++;
+
         sleep (1); /* do not run so fast! */
-    }
+ 
+        /* Write any number of messages, re-using the existing string-buffer: no leak!!. */
+        for (i = 1; i <= NUM_MSG; i++) {
+            printCurrentTime(*participant);
+
+            buf.str( string("") );
+            msg->index = i;
+            buf << "Message no. " << i;
+            msg->content = string_dup( buf.str().c_str() );
+            cout << "Writing message: \"" << msg->content << "\"" << endl;
+            status = talker->write(*msg, userHandle);
+            checkStatus(status, "Chat::ChatMessageDataWriter::write");
+            sentCount++;
+            sleep (1); /* do not run so fast! */
+        }
 
-    /* Leave the room by disposing and unregistering the message instance. */
-    status = talker->dispose(*msg, userHandle);
-    checkStatus(status, "Chat::ChatMessageDataWriter::dispose");
-    status = talker->unregister_instance(*msg, userHandle);
-    checkStatus(status, "Chat::ChatMessageDataWriter::unregister_instance");
+        /* Announce the end of the run, so receivers know how many messages to expect. */
+        announcement.kind = RUN_END;
+        announcement.sentCount = sentCount;
+        status = runAnnouncer->write(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::write (RUN_END)");
+
+        /* The run is over: keep it out of the history of later receivers. */
+        status = runAnnouncer->dispose(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::dispose");
+
+        /* Leave the room by disposing and unregistering the message instance. */
+        status = talker->dispose(*msg, userHandle);
+        checkStatus(status, "Chat::ChatMessageDataWriter::dispose");
+        status = talker->unregister_instance(*msg, userHandle);
+        checkStatus(status, "Chat::ChatMessageDataWriter::unregister_instance");
+
+        /* Also unregister our name. */
+        status = nameServer->unregister_instance(ns, HANDLE_NIL);
+        checkStatus(status, "Chat::NameServiceDataWriter::unregister_instance");
+    }
 
-    /* Also unregister our name. */
-    status = nameServer->unregister_instance(ns, HANDLE_NIL);
-    checkStatus(status, "Chat::NameServiceDataWriter::unregister_instance");
+    /* Anything that went wrong on the way out. */
+    cout << "Sent " << sentCount << " messages. ";
+    monitor.report(cout);
+    if (stats) {
+        stats->begin("summary");
+        stats->integer("userID", ownID);
+        stats->integer("sent", sentCount);
+        stats->number("duration_s", nanosToSeconds(currentTimeNanos() - startTime));
+        if (replay) {
+            stats->text("replay", replayFile);
+            stats->number("speed", speed);
+            stats->number("join_rate", joinRate);
+            stats->histogram("schedule_lag_us", lag, 1000.0);
+        }
+        stats->statuses(monitor);
+        stats->end();
+    }
 
     /* Release the data-samples. */
     delete msg;     // msg allocated on heap: explicit de-allocation required!!
+    delete replay;
+    delete stats;
 
     /* Remove the DataWriters */
     status = chatPublisher->delete_datawriter( talker.in() );
@@ -273,11 +417,18 @@ main (
     status = chatPublisher->delete_datawriter( nameServer.in() );
     checkStatus(status, "DDS::Publisher::delete_datawriter (nameServer)");
     
+    status = chatPublisher->delete_datawriter( runAnnouncer.in() );
+    checkStatus(status, "DDS::Publisher::delete_datawriter (runAnnouncer)");
+    DDS::release(writerStatus);
+    
     /* Remove the Publisher. */
     status = participant->delete_publisher( chatPublisher.in() );
     checkStatus(status, "DDS::DomainParticipant::delete_publisher");
     
     /* Remove the Topics. */
+    status = participant->delete_topic( runControlTopic.in() );
+    checkStatus(status, "DDS::DomainParticipant::delete_topic (runControlTopic)");
+    
     status = participant->delete_topic( nameServiceTopic.in() );
     checkStatus(status, "DDS::DomainParticipant::delete_topic (nameServiceTopic)");
     
@@ -297,6 +448,120 @@ main (
     return 0;
 }
 
+/**
+ * Writes the messages of the replay at their original times, scaled by the
+ * speed, as userIDs firstID, firstID + 1, ... Every user is registered and
+ * announced before the first message, so the writes only write; the names
+ * are written joinRate per second (all at once for 0), and the source
+ * timestamp of each tells a UserLoad when it was announced. Returns the
+ * number of messages written.
+ **/
+LongLong replayMessages(
+    Replay &replay,
+    ChatMessageDataWriter_ptr talker,
+    NameServiceDataWriter_ptr nameServer,
+    RunControlDataWriter_ptr runAnnouncer,
+    Long firstID,
+    double speed,
+    double joinRate,
+    ULong configHash,
+    Histogram &lag)
+{
+    const std::vector<ReplayMessage> &messages = replay.getMessages();
+    ULong                           users = replay.getUsers();
+    std::vector<InstanceHandle_t>   handles(users);
+    std::vector<LongLong>           sent(users, 0);
+    ChatMessage                     msg;
+    NameService                     ns;
+    RunControl                      announcement;
+    std::string                     content;
+    LongLong                        start;
+    LongLong                        due;
+    ReturnCode_t                    status;
+
+    /* Map every user of the replay onto an instance of its own. */
+    start = currentTimeNanos();
+    for (ULong u = 0; u < users; u++) {
+        ostringstream name;
+
+        if (joinRate > 0) {
+            sleepUntilNanos(start + (LongLong)(u * 1.0E9 / joinRate));
+        }
+        name << "Replay of " << replay.getUserID(u);
+        ns.userID = firstID + u;
+        ns.name = string_dup(name.str().c_str());
+        status = nameServer->write(ns, HANDLE_NIL);
+        checkStatus(status, "Chat::NameServiceDataWriter::write (replay)");
+
+        msg.userID = firstID + u;
+        handles[u] = talker->register_instance(msg);
+
+        announcement.userID = firstID + u;
+        announcement.kind = RUN_START;
+        announcement.sentCount = 0;
+        announcement.configHash = configHash;
+        status = runAnnouncer->write(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::write (RUN_START)");
+    }
+    cout << "Replaying " << messages.size() << " messages of " << users << " users";
+    if (speed > 0) {
+        cout << " at " << speed << " times the original rate" << endl;
+    } else {
+        cout << " as fast as possible" << endl;
+    }
+
+    start = currentTimeNanos();
+    for (ULong i = 0; i < messages.size(); i++) {
+        const ReplayMessage &message = messages[i];
+
+        if (speed > 0) {
+            due = start + (LongLong)(message.time / speed);
+            sleepUntilNanos(due);
+            lag.record(currentTimeNanos() - due);
+        }
+
+        /* The capture keeps only the start of the content: pad it to the original size. */
+        content = message.content;
+        content.resize(message.length, '.');
+        msg.userID = firstID + message.user;
+        msg.index = sent[message.user];
+        msg.content = string_dup(content.c_str());
+        status = talker->write(msg, handles[message.user]);
+        checkStatus(status, "Chat::ChatMessageDataWriter::write (replay)");
+        sent[message.user]++;
+    }
+    cout << "Replayed in " << fixed << setprecision(3)
+         << nanosToSeconds(currentTimeNanos() - start) << " s, "
+         << nanosToSeconds(messages.back().time) << " s originally" << endl;
+    if (speed > 0) {
+        cout << "Schedule lag (us): ";
+        lag.print(cout, 1000.0);
+        cout << endl;
+    }
+
+    /* End the runs and leave the room, as every Chatter does. */
+    for (ULong u = 0; u < users; u++) {
+        announcement.userID = firstID + u;
+        announcement.kind = RUN_END;
+        announcement.sentCount = sent[u];
+        status = runAnnouncer->write(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::write (RUN_END)");
+        status = runAnnouncer->dispose(announcement, HANDLE_NIL);
+        checkStatus(status, "Chat::RunControlDataWriter::dispose");
+
+        msg.userID = firstID + u;
+        status = talker->dispose(msg, handles[u]);
+        checkStatus(status, "Chat::ChatMessageDataWriter::dispose");
+        status = talker->unregister_instance(msg, handles[u]);
+        checkStatus(status, "Chat::ChatMessageDataWriter::unregister_instance");
+
+        ns.userID = firstID + u;
+        status = nameServer->unregister_instance(ns, HANDLE_NIL);
+        checkStatus(status, "Chat::NameServiceDataWriter::unregister_instance");
+    }
+    return messages.size();
+}
+
 void printTopicQos(DDS::TopicQos topicQos) {
   cout << endl;
   
@@ -0,0 +1,85 @@
+/************************************************************************
+ * LOGICAL_NAME:    CycleProfile.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the profile of the CPU cycles
+ * spent per sample in the phases of a receive path.
+ * 
+ ***/
+
+#include <iomanip>
+#include <stdlib.h>
+
+#include "CycleProfile.h"
+#include "Atomic.h"
+#include "Timing.h"
+
+using namespace std;
+
+CycleProfile::CycleProfile(const char *name) : name(name), phases(0)
+{
+    for (DDS::ULong i = 0; i < PROFILE_MAX_PHASES; i++) {
+        phaseNames[i] = NULL;
+        cycles[i] = 0;
+        samples[i] = 0;
+    }
+}
+
+DDS::ULong CycleProfile::addPhase(const char *phaseName)
+{
+    if (phases == PROFILE_MAX_PHASES) {
+        cerr << "Too many phases in the " << name << " profile" << endl;
+        exit(-1);
+    }
+    phaseNames[phases] = phaseName;
+    return phases++;
+}
+
+void CycleProfile::record(DDS::ULong phase, DDS::ULongLong batchCycles, DDS::ULong batchSamples)
+{
+    /* Polls that found nothing still cost cycles; they count in the totals only. */
+    __sync_fetch_and_add(&cycles[phase], batchCycles);
+    if (batchSamples > 0) {
+        __sync_fetch_and_add(&samples[phase], (DDS::ULongLong)batchSamples);
+        perSample[phase].record(batchCycles / batchSamples, batchSamples);
+    }
+}
+
+void CycleProfile::reportInterval(std::ostream &out, const char *prefix)
+{
+    for (DDS::ULong i = 0; i < phases; i++) {
+        perSample[i].snapshot(interval);
+        interval.subtract(reported[i]);
+        out << prefix << name << " cycles per sample, " << phaseNames[i] << ": ";
+        interval.print(out, 1.0);
+        out << endl;
+        reported[i].merge(interval);
+    }
+}
+
+void CycleProfile::report(std::ostream &out)
+{
+    DDS::ULongLong allCycles = 0;
+    DDS::ULongLong delivered = 0;
+
+    out << name << " cycles per sample (" << fixed << setprecision(2)
+        << cyclesPerNano() << " cycles per ns):" << endl;
+    for (DDS::ULong i = 0; i < phases; i++) {
+        out << "  " << phaseNames[i] << ": ";
+        perSample[i].print(out, 1.0);
+        out << endl;
+        DDS::ULongLong phaseSamples = atomicRead(samples[i]);
+
+        allCycles += atomicRead(cycles[i]);
+        if (phaseSamples > delivered) {
+            delivered = phaseSamples;
+        }
+    }
+    if (delivered > 0) {
+        out << "  all phases: " << allCycles << " cycles, " << setprecision(1)
+            << (double)allCycles / delivered << " per sample" << endl;
+    }
+}
@@ -0,0 +1,61 @@
+/************************************************************************
+ * LOGICAL_NAME:    CycleProfile.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the profile of the CPU cycles spent
+ * per sample in the phases of a receive path.
+ * 
+ ***/
+
+#ifndef __CYCLEPROFILE_H__
+#define __CYCLEPROFILE_H__
+
+#include <iostream>
+
+#include "ccpp_dds_dcps.h"
+#include "Histogram.h"
+
+#define PROFILE_MAX_PHASES 4
+
+/**
+ * Collects the cycles per sample of up to PROFILE_MAX_PHASES phases, e.g.
+ * take, processing and return_loan. Every measurement covers one batch and
+ * is divided over the samples in it; each of those samples adds that value
+ * to the distribution of its phase, so a batch of 100 weighs 100 times as
+ * much as a single sample. The totals are kept next to it. Recording is
+ * safe from any thread, the reports are made by a single thread.
+ **/
+class CycleProfile {
+
+    const char                          *name;
+    DDS::ULong                          phases;
+    const char                          *phaseNames[PROFILE_MAX_PHASES];
+    Histogram                           perSample[PROFILE_MAX_PHASES];
+    DDS::ULongLong                      cycles[PROFILE_MAX_PHASES];
+    DDS::ULongLong                      samples[PROFILE_MAX_PHASES];
+
+    /* Periodic reporting: the interval is the difference with the previous snapshot. */
+    Histogram                           reported[PROFILE_MAX_PHASES];
+    Histogram                           interval;
+
+public:
+    /* Constructor */
+    CycleProfile(const char *name);
+
+    /* Add a phase, returns its number; only before recording starts. */
+    DDS::ULong addPhase(const char *phaseName);
+
+    /* Account for one batch of the given number of samples (0 when nothing was there). */
+    void record(DDS::ULong phase, DDS::ULongLong batchCycles, DDS::ULong batchSamples);
+
+    /* Print the cycles per sample of every phase since the previous report. */
+    void reportInterval(std::ostream &out, const char *prefix);
+
+    /* Print the cycles per sample of every phase over the whole run. */
+    void report(std::ostream &out);
+};
+
+#endif
@@ -0,0 +1,495 @@
+/************************************************************************
+ * LOGICAL_NAME:    DepartureAccounting.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the accounting of the users
+ * that left the chatroom.
+ * 
+ ***/
+
+#include <sstream>
+#include <string.h>
+
+#include "DepartureAccounting.h"
+#include "WriterDepartures.h"
+#include "CheckStatus.h"
+
+using namespace std;
+
+DepartureAccounting::DepartureAccounting(
+    Chat::NameServiceDataReader_ptr nameServer,
+    Chat::ChatMessageDataReader_ptr loadAdmin
+) : nameServer(nameServer), loadAdmin(loadAdmin), writers(NULL), hook(NULL),
+    heldSamples(0), heldBytes(0) { }
+
+DepartureAccounting::~DepartureAccounting() { }
+
+/* Estimates the memory of a hash map: a node per entry with the value and
+   a next pointer, and a pointer per bucket. */
+template <class Map>
+static DDS::ULongLong
+mapBytes(const Map &map)
+{
+    return map.size() * (sizeof(typename Map::value_type) + sizeof(void *)) +
+        map.bucket_count() * sizeof(void *);
+}
+
+void DepartureAccounting::depart(DDS::Long userID, std::vector<Departure> &departures)
+{
+    DDS::ReturnCode_t status;
+    DDS::InstanceHandle_t handle;
+    Chat::NameService key;
+    Departure departure;
+
+    departure.userID = userID;
+    departure.messages = 0;
+    departure.missed = 0;
+
+    /* The messages first: while the name is there, late ones still count. */
+    countUser(userID, departure);
+
+    /* Take the name of this user only, so it does not show up again. */
+    key.userID = userID;
+    handle = nameServer->lookup_instance(key);
+    if (handle != DDS::HANDLE_NIL) {
+        status = nameServer->take_instance(
+            nsList,
+            nsInfo,
+            DDS::LENGTH_UNLIMITED,
+            handle,
+            DDS::ANY_SAMPLE_STATE,
+            DDS::ANY_VIEW_STATE,
+            DDS::ANY_INSTANCE_STATE);
+        checkStatus(status, "Chat::NameServiceDataReader::take_instance");
+        for (DDS::ULong j = 0; j < nsList.length(); j++) {
+            if (nsInfo[j].valid_data) {
+                departure.name = nsList[j].name.in();
+            }
+        }
+        status = nameServer->return_loan(nsList, nsInfo);
+        checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+    }
+    if (departure.name.empty()) {
+        ostringstream unnamed;
+        unnamed << "with userID " << userID;
+        departure.name = unnamed.str();
+    }
+    departures.push_back(departure);
+}
+
+void DepartureAccounting::setWriters(WriterDepartures *writers)
+{
+    this->writers = writers;
+}
+
+void DepartureAccounting::setConsumeHook(ConsumeHook *hook)
+{
+    this->hook = hook;
+}
+
+void DepartureAccounting::consume(DDS::ULong &valid, DDS::ULongLong &payload)
+{
+    valid = 0;
+    payload = 0;
+}
+
+DDS::ULong DepartureAccounting::getUsers() const
+{
+    return 0;
+}
+
+void DepartureAccounting::retain(DDS::ULong samples, DDS::ULongLong payload)
+{
+    heldSamples += samples;
+    heldBytes += payload;
+}
+
+void DepartureAccounting::released(const Chat::ChatMessage &message)
+{
+    DDS::ULongLong length = strlen(message.content);
+
+    /* Messages that arrived after the last read were never retained. */
+    if (heldSamples > 0) {
+        heldSamples--;
+    }
+    heldBytes = heldBytes > length ? heldBytes - length : 0;
+}
+
+DDS::ULongLong DepartureAccounting::getHeldBytes() const
+{
+    return heldBytes + heldSamples * (sizeof(Chat::ChatMessage) + sizeof(DDS::SampleInfo));
+}
+
+DDS::ULongLong DepartureAccounting::getLate() const
+{
+    return 0;
+}
+
+bool DepartureAccounting::needsHistory(const char *kind)
+{
+    return strcmp(kind, "count") != 0;
+}
+
+DepartureAccounting *
+DepartureAccounting::create(
+    const char *kind,
+    Chat::NameServiceDataReader_ptr nameServer,
+    Chat::ChatMessageDataReader_ptr loadAdmin)
+{
+    if (strcmp(kind, "legacy") == 0) {
+        return new LegacyAccounting(nameServer, loadAdmin);
+    } else if (strcmp(kind, "bulk") == 0) {
+        return new BulkAccounting(nameServer, loadAdmin);
+    } else if (strcmp(kind, "count") == 0) {
+        return new CountingAccounting(nameServer, loadAdmin);
+    }
+    return NULL;
+}
+
+LegacyAccounting::LegacyAccounting(
+    Chat::NameServiceDataReader_ptr nameServer,
+    Chat::ChatMessageDataReader_ptr loadAdmin
+) : DepartureAccounting(nameServer, loadAdmin)
+{
+    /* Initialize the Query Arguments. */
+    args.length(1);
+    args[0UL] = "0";
+
+    /* Create a QueryCondition that will contain all messages with userID=ownID */
+    singleUser = loadAdmin->create_querycondition(
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::ANY_INSTANCE_STATE,
+        "userID=%0",
+        args);
+    checkHandle(singleUser, "DDS::DataReader::create_querycondition");
+}
+
+LegacyAccounting::~LegacyAccounting()
+{
+    DDS::ReturnCode_t status = loadAdmin->delete_readcondition(singleUser);
+    checkStatus(status, "DDS::DataReader::delete_readcondition (singleUser)");
+}
+
+void LegacyAccounting::collect(std::vector<Departure> &departures)
+{
+    DDS::ReturnCode_t status;
+
+    /* Take the effected users so they will not appear in the list later on. */
+    status = nameServer->take(
+        nsList,
+        nsInfo,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::NOT_ALIVE_NO_WRITERS_INSTANCE_STATE);
+    checkStatus(status, "Chat::NameServiceDataReader::take");
+
+    for (DDS::ULong j = 0; j < nsList.length(); j++) {
+        Departure departure;
+
+        departure.userID = nsList[j].userID;
+        departure.name = nsList[j].name.in();
+        departure.messages = 0;
+        departure.missed = 0;
+        countUser(nsList[j].userID, departure);
+        departures.push_back(departure);
+    }
+    status = nameServer->return_loan(nsList, nsInfo);
+    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+}
+
+void LegacyAccounting::countUser(DDS::Long userID, Departure &departure)
+{
+    DDS::ReturnCode_t status;
+
+    /* re-apply query arguments */
+    ostringstream numberString;
+    numberString << userID;
+    args[0UL] = numberString.str().c_str();
+    status = singleUser->set_query_parameters(args);
+    checkStatus(status, "DDS::QueryCondition::set_query_parameters");
+
+    /* Read this users history */
+    status = loadAdmin->take_w_condition(
+        msgList,
+        msgInfo,
+        DDS::LENGTH_UNLIMITED,
+        singleUser);
+    checkStatus(status, "Chat::ChatMessageDataReader::take_w_condition");
+
+    for (DDS::ULong k = 0; k < msgList.length(); k++) {
+        if (msgInfo[k].valid_data) {
+            departure.messages++;
+            released(msgList[k]);
+        }
+    }
+
+    status = loadAdmin->return_loan(msgList, msgInfo);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+}
+
+BulkAccounting::BulkAccounting(
+    Chat::NameServiceDataReader_ptr nameServer,
+    Chat::ChatMessageDataReader_ptr loadAdmin
+) : DepartureAccounting(nameServer, loadAdmin) { }
+
+void BulkAccounting::collect(std::vector<Departure> &departures)
+{
+    DDS::ReturnCode_t status;
+
+    status = nameServer->take(
+        nsList,
+        nsInfo,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::NOT_ALIVE_NO_WRITERS_INSTANCE_STATE);
+    checkStatus(status, "Chat::NameServiceDataReader::take");
+    if (status == DDS::RETCODE_NO_DATA) {
+        return;
+    }
+
+    /* One take for the history of all instances that left: disposed by a
+       Chatter that quit, or without writers after one crashed. */
+    status = loadAdmin->take(
+        msgList,
+        msgInfo,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::NOT_ALIVE_INSTANCE_STATE);
+    checkStatus(status, "Chat::ChatMessageDataReader::take");
+    for (DDS::ULong k = 0; k < msgList.length(); k++) {
+        if (msgInfo[k].valid_data) {
+            counts[msgList[k].userID]++;
+            released(msgList[k]);
+        }
+    }
+    status = loadAdmin->return_loan(msgList, msgInfo);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+
+    /* All departures in one pass over the names. */
+    for (DDS::ULong j = 0; j < nsList.length(); j++) {
+        Departure departure;
+        CountMap::iterator count = counts.find(nsList[j].userID);
+
+        departure.userID = nsList[j].userID;
+        departure.name = nsList[j].name.in();
+        departure.messages = 0;
+        departure.missed = 0;
+        if (count != counts.end()) {
+            departure.messages = count->second;
+            counts.erase(count);
+        } else {
+            /* The name left before the messages: their instance is still
+               alive, so the bulk take missed it. Take it by its handle. */
+            countUser(nsList[j].userID, departure);
+        }
+        departures.push_back(departure);
+    }
+    status = nameServer->return_loan(nsList, nsInfo);
+    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+}
+
+void BulkAccounting::countUser(DDS::Long userID, Departure &departure)
+{
+    DDS::ReturnCode_t status;
+    DDS::InstanceHandle_t handle;
+    Chat::ChatMessage key;
+    CountMap::iterator count = counts.find(userID);
+
+    /* What an earlier bulk take left, and the history of this instance only. */
+    if (count != counts.end()) {
+        departure.messages += count->second;
+        counts.erase(count);
+    }
+    key.userID = userID;
+    handle = loadAdmin->lookup_instance(key);
+    if (handle == DDS::HANDLE_NIL) {
+        return;
+    }
+    status = loadAdmin->take_instance(
+        msgList,
+        msgInfo,
+        DDS::LENGTH_UNLIMITED,
+        handle,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::ANY_INSTANCE_STATE);
+    checkStatus(status, "Chat::ChatMessageDataReader::take_instance");
+    for (DDS::ULong k = 0; k < msgList.length(); k++) {
+        if (msgInfo[k].valid_data) {
+            departure.messages++;
+            released(msgList[k]);
+        }
+    }
+    status = loadAdmin->return_loan(msgList, msgInfo);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+}
+
+DDS::ULong BulkAccounting::getUsers() const
+{
+    return counts.size();
+}
+
+DDS::ULongLong BulkAccounting::getHeldBytes() const
+{
+    return DepartureAccounting::getHeldBytes() + mapBytes(counts);
+}
+
+CountingAccounting::CountingAccounting(
+    Chat::NameServiceDataReader_ptr nameServer,
+    Chat::ChatMessageDataReader_ptr loadAdmin
+) : DepartureAccounting(nameServer, loadAdmin),
+    unmeteredSamples(0), unmeteredBytes(0), lateSamples(0) { }
+
+void CountingAccounting::consume(DDS::ULong &valid, DDS::ULongLong &payload)
+{
+    takeCounts(valid, payload);
+
+    /* Including what was taken for a departure since the previous call. */
+    valid += unmeteredSamples;
+    payload += unmeteredBytes;
+    unmeteredSamples = 0;
+    unmeteredBytes = 0;
+}
+
+void CountingAccounting::takeCounts(DDS::ULong &valid, DDS::ULongLong &payload)
+{
+    DDS::ReturnCode_t status;
+
+    valid = 0;
+    payload = 0;
+
+    /* Take, not read: the history is freed right away, together with the
+       instances that were disposed or unregistered. */
+    status = loadAdmin->take(
+        msgList,
+        msgInfo,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::ANY_INSTANCE_STATE);
+    checkStatus(status, "Chat::ChatMessageDataReader::take");
+    for (DDS::ULong k = 0; k < msgList.length(); k++) {
+        if (msgInfo[k].valid_data) {
+            DDS::ULong length = strlen(msgList[k].content);
+
+            payload += length;
+            valid++;
+            if (counts.find(msgList[k].userID) == counts.end() &&
+                msgInfo[k].instance_state != DDS::ALIVE_INSTANCE_STATE && departed(msgList[k].userID)) {
+                lateSamples++;
+            } else {
+                UserCount &count = counts[msgList[k].userID];
+
+                if (count.received == 0 || msgList[k].index > count.highest) {
+                    count.highest = msgList[k].index;
+                }
+                count.received++;
+            }
+            if (hook) {
+                hook->consumed(msgList[k].userID, length);
+            }
+            if (writers) {
+                writers->userSeen(msgInfo[k].publication_handle, msgList[k].userID);
+            }
+        }
+    }
+    status = loadAdmin->return_loan(msgList, msgInfo);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+}
+
+bool CountingAccounting::departed(DDS::Long userID)
+{
+    Chat::NameService key;
+
+    /* The name is taken when the user is reported. */
+    key.userID = userID;
+    return nameServer->lookup_instance(key) == DDS::HANDLE_NIL;
+}
+
+void CountingAccounting::collect(std::vector<Departure> &departures)
+{
+    DDS::ReturnCode_t status;
+    DDS::ULong valid;
+    DDS::ULongLong payload;
+
+    /* The last messages may not have been consumed yet; count them while
+       the names are still there. */
+    takeCounts(valid, payload);
+    unmeteredSamples += valid;
+    unmeteredBytes += payload;
+
+    status = nameServer->take(
+        nsList,
+        nsInfo,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::NOT_ALIVE_NO_WRITERS_INSTANCE_STATE);
+    checkStatus(status, "Chat::NameServiceDataReader::take");
+    if (status == DDS::RETCODE_NO_DATA) {
+        return;
+    }
+
+    for (DDS::ULong j = 0; j < nsList.length(); j++) {
+        Departure departure;
+        CountMap::iterator count = counts.find(nsList[j].userID);
+
+        departure.userID = nsList[j].userID;
+        departure.name = nsList[j].name.in();
+        departure.messages = 0;
+        departure.missed = 0;
+        if (count != counts.end()) {
+            departure.messages = count->second.received;
+            if ((DDS::ULongLong)count->second.highest + 1 > count->second.received) {
+                departure.missed = count->second.highest + 1 - count->second.received;
+            }
+            counts.erase(count);
+        }
+        departures.push_back(departure);
+    }
+    status = nameServer->return_loan(nsList, nsInfo);
+    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+}
+
+void CountingAccounting::countUser(DDS::Long userID, Departure &departure)
+{
+    DDS::ULong valid;
+    DDS::ULongLong payload;
+    CountMap::iterator count;
+
+    /* The last messages may not have been consumed yet. */
+    takeCounts(valid, payload);
+    unmeteredSamples += valid;
+    unmeteredBytes += payload;
+
+    count = counts.find(userID);
+    if (count != counts.end()) {
+        departure.messages += count->second.received;
+        if ((DDS::ULongLong)count->second.highest + 1 > count->second.received) {
+            departure.missed = count->second.highest + 1 - count->second.received;
+        }
+        counts.erase(count);
+    }
+}
+
+DDS::ULong CountingAccounting::getUsers() const
+{
+    return counts.size();
+}
+
+DDS::ULongLong CountingAccounting::getHeldBytes() const
+{
+    return mapBytes(counts);
+}
+
+DDS::ULongLong CountingAccounting::getLate() const
+{
+    return lateSamples;
+}
@@ -0,0 +1,228 @@
+/************************************************************************
+ * LOGICAL_NAME:    DepartureAccounting.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the accounting of the users that
+ * left the chatroom and the messages they sent, as done by the UserLoad.
+ * 
+ ***/
+
+#ifndef __DEPARTUREACCOUNTING_H__
+#define __DEPARTUREACCOUNTING_H__
+
+#include <string>
+#include <vector>
+#include <tr1/unordered_map>
+
+#include "ccpp_dds_dcps.h"
+#include "ccpp_Chat.h"
+
+class WriterDepartures;
+
+/**
+ * Told about every message an accounting consumes, e.g. to find the top
+ * talkers, without the accounting depending on what is done with them.
+ **/
+class ConsumeHook {
+public:
+    virtual ~ConsumeHook() {}
+
+    /* A message of the given user with the given payload was taken. */
+    virtual void consumed(DDS::Long userID, DDS::ULong length) = 0;
+};
+
+/**
+ * A user that left, and the number of messages it sent.
+ **/
+struct Departure {
+    DDS::Long                           userID;
+    std::string                         name;
+    DDS::ULongLong                      messages;
+    DDS::ULongLong                      missed;         /* by the index, when counting */
+};
+
+/**
+ * Takes the NameService samples of the users whose writers are gone and
+ * finds out how many messages each of them sent, from the history of a
+ * KEEP_ALL ChatMessage reader or from counts kept while the messages
+ * arrived. Must be deleted before the readers.
+ **/
+class DepartureAccounting {
+
+protected:
+    Chat::NameServiceDataReader_ptr     nameServer;     /* owned by the caller */
+    Chat::ChatMessageDataReader_ptr     loadAdmin;      /* owned by the caller */
+    Chat::NameServiceSeq                nsList;
+    DDS::SampleInfoSeq                  nsInfo;
+    Chat::ChatMessageSeq                msgList;
+    DDS::SampleInfoSeq                  msgInfo;
+    WriterDepartures                    *writers;       /* NULL, or told the writers of the users */
+    ConsumeHook                         *hook;          /* NULL, or told every message consumed */
+    DDS::ULongLong                      heldSamples;    /* read, still in the history */
+    DDS::ULongLong                      heldBytes;
+
+    /* Take the messages of one user that left and add their count to the departure. */
+    virtual void countUser(DDS::Long userID, Departure &departure) = 0;
+
+    /* Account for a message of the history that was taken. */
+    void released(const Chat::ChatMessage &message);
+
+public:
+    /* Constructor */
+    DepartureAccounting(
+        Chat::NameServiceDataReader_ptr nameServer,
+        Chat::ChatMessageDataReader_ptr loadAdmin);
+
+    /* Destructor */
+    virtual ~DepartureAccounting();
+
+    /* Take the users that left since the previous call and append them to departures. */
+    virtual void collect(std::vector<Departure> &departures) = 0;
+
+    /* Take the name and the messages of the one user given, whose writer is
+       known to be gone, and append it to departures; no other user is looked at. */
+    void depart(DDS::Long userID, std::vector<Departure> &departures);
+
+    /* Have consume tell the writers of the users it sees. */
+    void setWriters(WriterDepartures *writers);
+
+    /* Have consume tell the hook about every message it takes; owned by the caller. */
+    void setConsumeHook(ConsumeHook *hook);
+
+    /* Take and count the messages that arrived, returning their number and
+       payload; only for an accounting that does not need the history. */
+    virtual void consume(DDS::ULong &valid, DDS::ULongLong &payload);
+
+    /* Returns the number of users with counts in memory. */
+    virtual DDS::ULong getUsers() const;
+
+    /* Account for messages that were read and stay in the history until their user leaves. */
+    void retain(DDS::ULong samples, DDS::ULongLong payload);
+
+    /* Returns an estimate of the memory kept for the users that did not
+       leave yet: their history in the reader, at least its payload, sample
+       and SampleInfo, and any counts. */
+    virtual DDS::ULongLong getHeldBytes() const;
+
+    /* Returns the number of messages that arrived after their user was reported. */
+    virtual DDS::ULongLong getLate() const;
+
+    /* Returns whether the given kind needs a KEEP_ALL history of the messages. */
+    static bool needsHistory(const char *kind);
+
+    /* Returns a new accounting of the given kind ("legacy", "bulk" or "count"), NULL if unknown. */
+    static DepartureAccounting *create(
+        const char *kind,
+        Chat::NameServiceDataReader_ptr nameServer,
+        Chat::ChatMessageDataReader_ptr loadAdmin);
+};
+
+/**
+ * The original accounting: for every departed user the query is set to its
+ * userID and its history is taken, so the work grows with the number of
+ * users times the history, plus a query change per user.
+ **/
+class LegacyAccounting : public DepartureAccounting {
+
+    DDS::QueryCondition_ptr             singleUser;
+    DDS::StringSeq                      args;
+
+protected:
+    virtual void countUser(DDS::Long userID, Departure &departure);
+
+public:
+    /* Constructor */
+    LegacyAccounting(
+        Chat::NameServiceDataReader_ptr nameServer,
+        Chat::ChatMessageDataReader_ptr loadAdmin);
+
+    /* Destructor */
+    virtual ~LegacyAccounting();
+
+    virtual void collect(std::vector<Departure> &departures);
+};
+
+/**
+ * Takes the history of all instances that are no longer alive at once and
+ * counts it per userID in a hash map, then looks up every departed user.
+ * Counts of users whose name has not left yet stay in the map until it
+ * does, so no message is counted twice or lost between calls. A user whose
+ * name left while its messages were still alive has its history taken by
+ * instance, so it is counted as the legacy accounting counts it.
+ **/
+class BulkAccounting : public DepartureAccounting {
+
+    typedef std::tr1::unordered_map<DDS::Long, DDS::ULongLong> CountMap;
+
+    CountMap                            counts;         /* messages taken, not reported yet */
+
+protected:
+    virtual void countUser(DDS::Long userID, Departure &departure);
+
+public:
+    /* Constructor */
+    BulkAccounting(
+        Chat::NameServiceDataReader_ptr nameServer,
+        Chat::ChatMessageDataReader_ptr loadAdmin);
+
+    virtual void collect(std::vector<Departure> &departures);
+
+    virtual DDS::ULong getUsers() const;
+
+    virtual DDS::ULongLong getHeldBytes() const;
+};
+
+/**
+ * Takes the messages as they arrive and only keeps a count and the highest
+ * index per userID, so the reader needs no more history than a burst and
+ * the memory grows with the number of users, not with the messages. The
+ * indices of a Chatter start at 0, so a gap between the count and the
+ * highest index shows messages the history overwrote before the take.
+ * Messages that only arrive after their user was reported, when its name
+ * is already gone, are counted as late instead of starting a new count
+ * that nothing would remove.
+ **/
+class CountingAccounting : public DepartureAccounting {
+
+    struct UserCount {
+        DDS::ULongLong                  received;
+        DDS::Long                       highest;        /* highest index seen */
+    };
+
+    typedef std::tr1::unordered_map<DDS::Long, UserCount> CountMap;
+
+    CountMap                            counts;         /* per user that has not left yet */
+    DDS::ULong                          unmeteredSamples;
+    DDS::ULongLong                      unmeteredBytes; /* taken outside consume */
+    DDS::ULongLong                      lateSamples;    /* of users already reported */
+
+    /* Take the messages that arrived and count them per user. */
+    void takeCounts(DDS::ULong &valid, DDS::ULongLong &payload);
+
+    /* Returns whether the user was reported already. */
+    bool departed(DDS::Long userID);
+
+protected:
+    virtual void countUser(DDS::Long userID, Departure &departure);
+
+public:
+    /* Constructor */
+    CountingAccounting(
+        Chat::NameServiceDataReader_ptr nameServer,
+        Chat::ChatMessageDataReader_ptr loadAdmin);
+
+    virtual void collect(std::vector<Departure> &departures);
+
+    virtual void consume(DDS::ULong &valid, DDS::ULongLong &payload);
+
+    virtual DDS::ULong getUsers() const;
+
+    virtual DDS::ULongLong getHeldBytes() const;
+
+    virtual DDS::ULongLong getLate() const;
+};
+
+#endif
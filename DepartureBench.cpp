@@ -0,0 +1,353 @@
+/************************************************************************
+ * LOGICAL_NAME:    DepartureBench.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the 'DepartureBench'
+ * executable, which compares the ways the UserLoad accounts for the users
+ * that leave, for growing numbers of users.
+ * 
+ ***/
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "ccpp_dds_dcps.h"
+#include "CheckStatus.h"
+#include "ccpp_Chat.h"
+#include "DepartureAccounting.h"
+#include "Timing.h"
+
+#define MESSAGES_PER_USER 10
+#define SETTLE_TIMEOUT 60.0         /* s for the readers to see all users leave */
+#define SETTLE_POLL 10000           /* us */
+
+using namespace DDS;
+using namespace Chat;
+
+static const char *accountingKinds[] = { "legacy", "bulk" };
+#define ACCOUNTING_KINDS 2
+
+/**
+ * Waits until the readers have seen the given number of users lose their
+ * writers, and the history of all their messages become not alive, so
+ * that every accounting finds the same state; returns false on a timeout.
+ **/
+static bool
+waitForDepartures(
+    NameServiceDataReader_ptr nameServer,
+    ChatMessageDataReader_ptr loadAdmin,
+    Long users,
+    Long messagesPerUser)
+{
+    NameServiceSeq                  nsList;
+    ChatMessageSeq                  msgList;
+    SampleInfoSeq                   infoSeq;
+    ReturnCode_t                    status;
+    Long                            departed;
+    Long                            history;
+    LongLong                        deadline = currentTimeNanos() + secondsToNanos(SETTLE_TIMEOUT);
+
+    do {
+        status = nameServer->read(
+            nsList,
+            infoSeq,
+            LENGTH_UNLIMITED,
+            ANY_SAMPLE_STATE,
+            ANY_VIEW_STATE,
+            NOT_ALIVE_NO_WRITERS_INSTANCE_STATE);
+        checkStatus(status, "Chat::NameServiceDataReader::read");
+        departed = nsList.length();
+        status = nameServer->return_loan(nsList, infoSeq);
+        checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+
+        status = loadAdmin->read(
+            msgList,
+            infoSeq,
+            LENGTH_UNLIMITED,
+            ANY_SAMPLE_STATE,
+            ANY_VIEW_STATE,
+            NOT_ALIVE_INSTANCE_STATE);
+        checkStatus(status, "Chat::ChatMessageDataReader::read");
+        history = 0;
+        for (ULong i = 0; i < msgList.length(); i++) {
+            if (infoSeq[i].valid_data) {
+                history++;
+            }
+        }
+        status = loadAdmin->return_loan(msgList, infoSeq);
+        checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+
+        if (departed >= users && history >= users * messagesPerUser) {
+            return true;
+        }
+        usleep(SETTLE_POLL);
+    } while (currentTimeNanos() < deadline);
+    return false;
+}
+
+int
+main (
+    int argc,
+    char *argv[])
+{
+    /* Generic DDS entities */
+    DomainParticipantFactory_var    dpf;
+    DomainParticipant_var           participant;
+    Topic_var                       chatMessageTopic;
+    Topic_var                       nameServiceTopic;
+    Publisher_var                   publisher;
+    Subscriber_var                  subscriber;
+    DataWriter_ptr                  parentWriter;
+    DataReader_ptr                  parentReader;
+
+    /* Type-specific DDS entities */
+    ChatMessageTypeSupport_var      chatMessageTS;
+    NameServiceTypeSupport_var      nameServiceTS;
+    ChatMessageDataWriter_var       talker;
+    NameServiceDataWriter_var       nameServer;
+    NameServiceDataReader_ptr       nameReaders[ACCOUNTING_KINDS];
+    ChatMessageDataReader_ptr       messageReaders[ACCOUNTING_KINDS];
+    DepartureAccounting             *accounting[ACCOUNTING_KINDS];
+
+    /* QosPolicy holders */
+    TopicQos                        topic_qos;
+    PublisherQos                    pub_qos;
+    SubscriberQos                   sub_qos;
+    DataWriterQos                   dw_qos;
+    DataReaderQos                   message_qos;
+
+    /* DDS Identifiers */
+    DomainId_t                      domain = NULL;
+    ReturnCode_t                    status;
+
+    /* Others */
+    char                            *chatMessageTypeName = NULL;
+    char                            *nameServiceTypeName = NULL;
+    std::vector<Long>               userCounts;
+    Long                            messagesPerUser = MESSAGES_PER_USER;
+    std::vector<Departure>          departures;
+    LongLong                        elapsed[ACCOUNTING_KINDS];
+    int                             opt;
+
+    /* Options: DepartureBench [-u users]... [-m messagesPerUser] */
+    /* Every -u adds a number of users to benchmark; 1000, 10000 and 100000 without. */
+    while ((opt = getopt(argc, argv, "u:m:")) != -1) {
+        switch (opt) {
+        case 'u':
+            userCounts.push_back(atoi(optarg));
+            break;
+        case 'm':
+            messagesPerUser = atoi(optarg);
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-u users]... [-m messagesPerUser]" << endl;
+            exit(1);
+        }
+    }
+    if (userCounts.empty()) {
+        userCounts.push_back(1000);
+        userCounts.push_back(10000);
+        userCounts.push_back(100000);
+    }
+
+    /* Create a DomainParticipantFactory and a DomainParticipant (using Default QoS settings. */
+    dpf = DomainParticipantFactory::get_instance();
+    checkHandle(dpf.in(), "DDS::DomainParticipantFactory::get_instance");
+    participant = dpf->create_participant(domain, PARTICIPANT_QOS_DEFAULT, NULL, STATUS_MASK_NONE);
+    checkHandle(participant.in(), "DDS::DomainParticipantFactory::create_participant");
+
+    /* Register the required datatypes. */
+    chatMessageTS = new ChatMessageTypeSupport();
+    checkHandle(chatMessageTS.in(), "new ChatMessageTypeSupport");
+    chatMessageTypeName = chatMessageTS->get_type_name();
+    status = chatMessageTS->register_type(participant.in(), chatMessageTypeName);
+    checkStatus(status, "Chat::ChatMessageTypeSupport::register_type");
+    nameServiceTS = new NameServiceTypeSupport();
+    checkHandle(nameServiceTS.in(), "new NameServiceTypeSupport");
+    nameServiceTypeName = nameServiceTS->get_type_name();
+    status = nameServiceTS->register_type(participant.in(), nameServiceTypeName);
+    checkStatus(status, "Chat::NameServiceTypeSupport::register_type");
+
+    /* Topics of its own, RELIABLE and VOLATILE, so that no chat is disturbed
+       and no users are left over from the previous round. */
+    status = participant->get_default_topic_qos(topic_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_topic_qos");
+    topic_qos.reliability.kind = RELIABLE_RELIABILITY_QOS;
+    chatMessageTopic = participant->create_topic(
+        "Bench_ChatMessage",
+        chatMessageTypeName,
+        topic_qos,
+        NULL,
+        STATUS_MASK_NONE);
+    checkHandle(chatMessageTopic.in(), "DDS::DomainParticipant::create_topic (ChatMessage)");
+    nameServiceTopic = participant->create_topic(
+        "Bench_NameService",
+        nameServiceTypeName,
+        topic_qos,
+        NULL,
+        STATUS_MASK_NONE);
+    checkHandle(nameServiceTopic.in(), "DDS::DomainParticipant::create_topic (NameService)");
+
+    /* A Publisher and a Subscriber in a Partition of their own. */
+    status = participant->get_default_publisher_qos(pub_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_publisher_qos");
+    pub_qos.partition.name.length(1);
+    pub_qos.partition.name[0] = "DepartureBench";
+    publisher = participant->create_publisher(pub_qos, NULL, STATUS_MASK_NONE);
+    checkHandle(publisher.in(), "DDS::DomainParticipant::create_publisher");
+    status = participant->get_default_subscriber_qos(sub_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_subscriber_qos");
+    sub_qos.partition.name.length(1);
+    sub_qos.partition.name[0] = "DepartureBench";
+    subscriber = participant->create_subscriber(sub_qos, NULL, STATUS_MASK_NONE);
+    checkHandle(subscriber.in(), "DDS::DomainParticipant::create_subscriber");
+
+    /* The ChatMessage readers keep all history, as in the UserLoad. */
+    status = subscriber->get_default_datareader_qos(message_qos);
+    checkStatus(status, "DDS::Subscriber::get_default_datareader_qos");
+    status = subscriber->copy_from_topic_qos(message_qos, topic_qos);
+    checkStatus(status, "DDS::Subscriber::copy_from_topic_qos");
+    message_qos.history.kind = KEEP_ALL_HISTORY_QOS;
+
+    cout << "Departure accounting, " << messagesPerUser << " messages per user:" << endl;
+    for (ULong round = 0; round < userCounts.size(); round++) {
+        Long users = userCounts[round];
+
+        /* A reader pair per accounting, so that both see all users leave. */
+        for (int k = 0; k < ACCOUNTING_KINDS; k++) {
+            parentReader = subscriber->create_datareader(
+                nameServiceTopic.in(),
+                DATAREADER_QOS_USE_TOPIC_QOS,
+                NULL,
+                STATUS_MASK_NONE);
+            checkHandle(parentReader, "DDS::Subscriber::create_datareader (NameService)");
+            nameReaders[k] = NameServiceDataReader::_narrow(parentReader);
+            checkHandle(nameReaders[k], "Chat::NameServiceDataReader::_narrow");
+
+            parentReader = subscriber->create_datareader(
+                chatMessageTopic.in(),
+                message_qos,
+                NULL,
+                STATUS_MASK_NONE);
+            checkHandle(parentReader, "DDS::Subscriber::create_datareader (ChatMessage)");
+            messageReaders[k] = ChatMessageDataReader::_narrow(parentReader);
+            checkHandle(messageReaders[k], "Chat::ChatMessageDataReader::_narrow");
+
+            accounting[k] = DepartureAccounting::create(accountingKinds[k], nameReaders[k], messageReaders[k]);
+        }
+
+        /* The writers, whose deletion makes all users leave at once. */
+        parentWriter = publisher->create_datawriter(
+            chatMessageTopic.in(),
+            DATAWRITER_QOS_USE_TOPIC_QOS,
+            NULL,
+            STATUS_MASK_NONE);
+        checkHandle(parentWriter, "DDS::Publisher::create_datawriter (ChatMessage)");
+        talker = ChatMessageDataWriter::_narrow(parentWriter);
+        checkHandle(talker.in(), "Chat::ChatMessageDataWriter::_narrow");
+        status = publisher->get_default_datawriter_qos(dw_qos);
+        checkStatus(status, "DDS::Publisher::get_default_datawriter_qos");
+        status = publisher->copy_from_topic_qos(dw_qos, topic_qos);
+        checkStatus(status, "DDS::Publisher::copy_from_topic_qos");
+        dw_qos.writer_data_lifecycle.autodispose_unregistered_instances = FALSE;
+        parentWriter = publisher->create_datawriter(
+            nameServiceTopic.in(),
+            dw_qos,
+            NULL,
+            STATUS_MASK_NONE);
+        checkHandle(parentWriter, "DDS::Publisher::create_datawriter (NameService)");
+        nameServer = NameServiceDataWriter::_narrow(parentWriter);
+        checkHandle(nameServer.in(), "Chat::NameServiceDataWriter::_narrow");
+
+        /* Every user announces its name and chats. */
+        for (Long u = 0; u < users; u++) {
+            NameService ns;
+            ChatMessage msg;
+            ostringstream name;
+            InstanceHandle_t userHandle;
+
+            name << "User " << u;
+            ns.userID = u;
+            ns.name = string_dup(name.str().c_str());
+            status = nameServer->write(ns, HANDLE_NIL);
+            checkStatus(status, "Chat::NameServiceDataWriter::write");
+
+            msg.userID = u;
+            userHandle = talker->register_instance(msg);
+            for (Long i = 0; i < messagesPerUser; i++) {
+                msg.index = i;
+                msg.content = string_dup("Message of the departure benchmark.");
+                status = talker->write(msg, userHandle);
+                checkStatus(status, "Chat::ChatMessageDataWriter::write");
+            }
+        }
+
+        /* Leave without a goodbye, as after a crash: the messages first. */
+        status = publisher->delete_datawriter(talker.in());
+        checkStatus(status, "DDS::Publisher::delete_datawriter (ChatMessage)");
+        status = publisher->delete_datawriter(nameServer.in());
+        checkStatus(status, "DDS::Publisher::delete_datawriter (NameService)");
+
+        for (int k = 0; k < ACCOUNTING_KINDS; k++) {
+            if (!waitForDepartures(nameReaders[k], messageReaders[k], users, messagesPerUser)) {
+                cerr << "Not all " << users << " users were seen to leave" << endl;
+                exit(-1);
+            }
+        }
+
+        /* Time each accounting and check that it got every message. */
+        cout << setw(8) << users << " users:";
+        for (int k = 0; k < ACCOUNTING_KINDS; k++) {
+            ULongLong counted = 0;
+            LongLong start;
+
+            departures.clear();
+            start = currentTimeNanos();
+            accounting[k]->collect(departures);
+            elapsed[k] = currentTimeNanos() - start;
+
+            for (ULong j = 0; j < departures.size(); j++) {
+                counted += departures[j].messages;
+            }
+            cout << " " << accountingKinds[k] << " " << fixed << setprecision(1)
+                 << elapsed[k] / 1.0E6 << " ms (" << setprecision(2)
+                 << (double)elapsed[k] / 1000.0 / users << " us/user";
+            if (departures.size() != (ULong)users || counted != (ULongLong)users * messagesPerUser) {
+                cout << ", " << departures.size() << " users and " << counted << " messages counted!";
+            }
+            cout << "),";
+        }
+        cout << " speedup " << setprecision(1)
+             << (elapsed[1] > 0 ? (double)elapsed[0] / elapsed[1] : 0.0) << endl;
+
+        /* Clean up for the next round. */
+        for (int k = 0; k < ACCOUNTING_KINDS; k++) {
+            delete accounting[k];
+            status = subscriber->delete_datareader(messageReaders[k]);
+            checkStatus(status, "DDS::Subscriber::delete_datareader (ChatMessage)");
+            status = subscriber->delete_datareader(nameReaders[k]);
+            checkStatus(status, "DDS::Subscriber::delete_datareader (NameService)");
+            DDS::release(messageReaders[k]);
+            DDS::release(nameReaders[k]);
+        }
+    }
+
+    /* Remove the type-names. */
+    string_free(chatMessageTypeName);
+    string_free(nameServiceTypeName);
+
+    /* Free all resources */
+    status = participant->delete_contained_entities();
+    checkStatus(status, "DDS::DomainParticipant::delete_contained_entities");
+    status = dpf->delete_participant(participant.in());
+    checkStatus(status, "DDS::DomainParticipantFactory::delete_participant");
+
+    return 0;
+}
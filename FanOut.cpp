@@ -0,0 +1,157 @@
+/************************************************************************
+ * LOGICAL_NAME:    FanOut.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the additional ChatMessage
+ * readers of the MessageBoard.
+ * 
+ ***/
+
+#include <iomanip>
+
+#include "FanOut.h"
+#include "CheckStatus.h"
+#include "Timing.h"
+
+ArrivalSkew::ArrivalSkew(DDS::ULong readers) : readers(readers), incomplete(0)
+{
+    window = secondsToNanos(SKEW_WINDOW);
+    nextExpiry = currentTimeNanos() + window;
+    pthread_mutex_init(&lock, NULL);
+}
+
+ArrivalSkew::~ArrivalSkew()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void ArrivalSkew::expire(DDS::LongLong now)
+{
+    ArrivalMap::iterator it = arrivals.begin();
+
+    while (it != arrivals.end()) {
+        if (now - it->second.first > window) {
+            it = arrivals.erase(it);
+            incomplete++;
+        } else {
+            it++;
+        }
+    }
+    nextExpiry = now + window;
+}
+
+void ArrivalSkew::arrived(DDS::InstanceHandle_t publication, DDS::Long userID, DDS::Long index, DDS::LongLong now)
+{
+    MessageKey key;
+
+    key.publication = publication;
+    key.userID = userID;
+    key.index = index;
+
+    pthread_mutex_lock(&lock);
+
+    /* One pass over all messages per window, so the map cannot grow without limit. */
+    if (now >= nextExpiry) {
+        expire(now);
+    }
+
+    ArrivalMap::iterator it = arrivals.find(key);
+    if (it == arrivals.end()) {
+        Arrival arrival;
+        arrival.first = now;
+        arrival.last = now;
+        arrival.readers = 1;
+        it = arrivals.insert(ArrivalMap::value_type(key, arrival)).first;
+    } else {
+        Arrival &arrival = it->second;
+        /* Readers are serviced by different threads, so not necessarily in order. */
+        if (now < arrival.first) {
+            arrival.first = now;
+        }
+        if (now > arrival.last) {
+            arrival.last = now;
+        }
+        arrival.readers++;
+    }
+    if (it->second.readers >= readers) {
+        skew.record(it->second.last - it->second.first);
+        arrivals.erase(it);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void ArrivalSkew::report(std::ostream &out)
+{
+    pthread_mutex_lock(&lock);
+    out << "Skew between " << readers << " readers (us): ";
+    skew.print(out, 1000.0);
+    out << endl;
+    if (incomplete > 0 || !arrivals.empty()) {
+        out << "  " << incomplete + arrivals.size() << " messages did not reach all readers" << endl;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+FanOutReader::FanOutReader(
+    Chat::ChatMessageDataReader_ptr reader,
+    ArrivalSkew &skew,
+    StatusMonitor &monitor
+) : StatusReaderListener(monitor), reader(reader), skew(skew), received(0)
+{
+    pthread_mutex_init(&lock, NULL);
+}
+
+FanOutReader::~FanOutReader()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void FanOutReader::takeMessages()
+{
+    DDS::ReturnCode_t status;
+
+    pthread_mutex_lock(&lock);
+
+    status = reader->take(
+        msgSeq,
+        infoSeq,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::ANY_INSTANCE_STATE );
+    checkStatus(status, "Chat::ChatMessageDataReader::take");
+
+    /* All messages of one take arrived at the same moment. */
+    DDS::LongLong now = currentTimeNanos();
+
+    for (DDS::ULong i = 0; i < msgSeq.length(); i++) {
+        if (infoSeq[i].valid_data) {
+            latency.record(now - toNanos(infoSeq[i].source_timestamp));
+            skew.arrived(infoSeq[i].publication_handle, msgSeq[i].userID, msgSeq[i].index, now);
+            received++;
+        }
+    }
+
+    status = reader->return_loan(msgSeq, infoSeq);
+    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+
+    pthread_mutex_unlock(&lock);
+}
+
+void FanOutReader::report(std::ostream &out)
+{
+    pthread_mutex_lock(&lock);
+    out << received << " messages, latency (us): ";
+    latency.print(out, 1000.0);
+    out << endl;
+    pthread_mutex_unlock(&lock);
+}
+
+void FanOutReader::on_data_available (
+    DDS::DataReader_ptr reader
+) THROW_ORB_EXCEPTIONS {
+    takeMessages();
+}
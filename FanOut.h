@@ -0,0 +1,125 @@
+/************************************************************************
+ * LOGICAL_NAME:    FanOut.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the additional ChatMessage readers
+ * of the MessageBoard, used to measure the cost of delivering one sample
+ * to many readers in the same process.
+ * 
+ ***/
+
+#ifndef __FANOUT_H__
+#define __FANOUT_H__
+
+#include <iostream>
+#include <pthread.h>
+#include <tr1/unordered_map>
+
+#include "ccpp_dds_dcps.h"
+#include "ccpp_Chat.h"
+#include "orb_abstraction.h"
+#include "Histogram.h"
+#include "StatusMonitor.h"
+
+/* Seconds after which a message that did not reach all readers is given up. */
+#define SKEW_WINDOW 10.0
+
+/**
+ * Collects, per message, when it reached each of the readers. A message is
+ * identified by its writer, userID and index, so a Chatter restarted with
+ * the same userID does not collide with its previous run. Once all readers
+ * have taken it, the time between the first and the last reader is
+ * recorded as its skew. Messages that some reader never gets, lost or
+ * filtered out, are dropped after SKEW_WINDOW and counted.
+ **/
+class ArrivalSkew {
+
+    struct MessageKey {
+        DDS::InstanceHandle_t           publication;
+        DDS::Long                       userID;
+        DDS::Long                       index;
+
+        bool operator==(const MessageKey &other) const {
+            return publication == other.publication && userID == other.userID && index == other.index;
+        }
+    };
+
+    struct MessageKeyHash {
+        size_t operator()(const MessageKey &key) const {
+            DDS::ULongLong h = (DDS::ULongLong)key.publication * 0x9e3779b97f4a7c15ULL;
+            h ^= ((DDS::ULongLong)(DDS::ULong)key.userID << 32) | (DDS::ULong)key.index;
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+
+    struct Arrival {
+        DDS::LongLong                   first;
+        DDS::LongLong                   last;
+        DDS::ULong                      readers;
+    };
+
+    typedef std::tr1::unordered_map<MessageKey, Arrival, MessageKeyHash> ArrivalMap;
+
+    DDS::ULong                          readers;
+    ArrivalMap                          arrivals;       /* messages some readers still miss */
+    Histogram                           skew;
+    DDS::LongLong                       window;         /* ns */
+    DDS::LongLong                       nextExpiry;
+    DDS::ULongLong                      incomplete;     /* given up after the window */
+    pthread_mutex_t                     lock;
+
+    /* Drop the messages that first arrived longer than the window ago. */
+    void expire(DDS::LongLong now);
+
+public:
+    /* Constructor */
+    ArrivalSkew(DDS::ULong readers);
+
+    /* Destructor */
+    ~ArrivalSkew();
+
+    /* One of the readers has taken the given message. */
+    void arrived(DDS::InstanceHandle_t publication, DDS::Long userID, DDS::Long index, DDS::LongLong now);
+
+    /* Print the skew between the readers, in microseconds. */
+    void report(std::ostream &out);
+};
+
+/**
+ * DataReaderListener that takes everything from one of the additional
+ * readers as soon as it is available, and records the latency for that
+ * reader. The monitored statuses of the reader are counted as well.
+ **/
+class FanOutReader : public StatusReaderListener {
+
+    Chat::ChatMessageDataReader_ptr     reader;         /* owned by the MessageBoard */
+    ArrivalSkew                         &skew;
+    Chat::ChatMessageSeq                msgSeq;
+    DDS::SampleInfoSeq                  infoSeq;
+    Histogram                           latency;
+    DDS::ULongLong                      received;
+    pthread_mutex_t                     lock;
+
+public:
+    /* Constructor */
+    FanOutReader(Chat::ChatMessageDataReader_ptr reader, ArrivalSkew &skew, StatusMonitor &monitor);
+
+    /* Destructor */
+    virtual ~FanOutReader();
+
+    /* Take and process all available ChatMessages. */
+    void takeMessages();
+
+    /* Print the number of messages and the latency of this reader. */
+    void report(std::ostream &out);
+
+    /* Callback method implementation. */
+    virtual void on_data_available (
+        DDS::DataReader_ptr reader
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+#endif
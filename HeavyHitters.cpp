@@ -0,0 +1,171 @@
+/************************************************************************
+ * LOGICAL_NAME:    HeavyHitters.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the tracking of the users that
+ * send most of the messages.
+ * 
+ ***/
+
+#include <iomanip>
+#include <algorithm>
+
+#include "HeavyHitters.h"
+#include "Timing.h"
+
+using namespace std;
+
+/* Orders counters largest first. */
+static bool
+largerCount(const Talker &a, const Talker &b)
+{
+    return a.count > b.count;
+}
+
+HeavyHitters::HeavyHitters(DDS::ULong capacity, DDS::ULong shown)
+    : capacity(capacity), shown(shown), messages(0)
+{
+    heap.reserve(capacity);
+    position.rehash(capacity);
+    reportedTime = currentTimeNanos();
+}
+
+void HeavyHitters::swapTalkers(DDS::ULong a, DDS::ULong b)
+{
+    swap(heap[a], heap[b]);
+    position[heap[a].userID] = a;
+    position[heap[b].userID] = b;
+}
+
+void HeavyHitters::siftDown(DDS::ULong i)
+{
+    DDS::ULong size = heap.size();
+
+    for (;;) {
+        DDS::ULong smallest = i;
+        DDS::ULong left = 2 * i + 1;
+        DDS::ULong right = left + 1;
+
+        if (left < size && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < size && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        swapTalkers(i, smallest);
+        i = smallest;
+    }
+}
+
+void HeavyHitters::siftUp(DDS::ULong i)
+{
+    while (i > 0 && heap[(i - 1) / 2].count > heap[i].count) {
+        swapTalkers(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+void HeavyHitters::record(DDS::Long userID, DDS::ULongLong bytes)
+{
+    PositionMap::iterator found = position.find(userID);
+
+    messages++;
+    if (found != position.end()) {
+        Talker &talker = heap[found->second];
+
+        talker.count++;
+        talker.bytes += bytes;
+        siftDown(found->second);
+    } else if (heap.size() < capacity) {
+        Talker talker;
+
+        talker.userID = userID;
+        talker.count = 1;
+        talker.error = 0;
+        talker.bytes = bytes;
+        talker.reportedCount = 0;
+        talker.reportedBytes = 0;
+        heap.push_back(talker);
+        position[userID] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    } else if (capacity > 0) {
+        /* Take over the smallest counter; the messages it held count as the error. */
+        Talker &talker = heap[0];
+
+        position.erase(talker.userID);
+        talker.userID = userID;
+        talker.error = talker.count;
+        talker.count++;
+        talker.bytes = bytes;
+        talker.reportedCount = talker.error;
+        talker.reportedBytes = 0;
+        position[userID] = 0;
+        siftDown(0);
+    }
+}
+
+void HeavyHitters::top(DDS::ULong count, std::vector<Talker> &talkers) const
+{
+    talkers = heap;
+    if (count < talkers.size()) {
+        partial_sort(talkers.begin(), talkers.begin() + count, talkers.end(), largerCount);
+        talkers.resize(count);
+    } else {
+        sort(talkers.begin(), talkers.end(), largerCount);
+    }
+}
+
+void HeavyHitters::report(std::ostream &out, StatsEmitter *stats)
+{
+    DDS::LongLong now = currentTimeNanos();
+    double seconds = nanosToSeconds(now - reportedTime);
+    std::vector<Talker> talkers;
+
+    /* The caller's stream, usually cout, gets its formatting back at the end. */
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    if (seconds <= 0) {
+        seconds = 1.0E-9;
+    }
+    top(shown, talkers);
+    out << "Top talkers of " << messages << " messages (" << heap.size()
+        << " of " << capacity << " counters in use):" << endl;
+    for (DDS::ULong i = 0; i < talkers.size(); i++) {
+        const Talker &talker = talkers[i];
+        double rate = (talker.count - talker.reportedCount) / seconds;
+        double byteRate = (talker.bytes - talker.reportedBytes) / seconds;
+
+        out << "  " << setw(2) << i + 1 << ". userID " << setw(8) << talker.userID
+            << ": " << talker.count;
+        if (talker.error > 0) {
+            out << " (-" << talker.error << ")";
+        }
+        out << " messages, " << fixed << setprecision(1) << rate << " msg/s, "
+            << byteRate / 1024.0 << " KB/s" << endl;
+        if (stats) {
+            stats->begin("talker");
+            stats->integer("rank", i + 1);
+            stats->integer("userID", talker.userID);
+            stats->integer("messages", talker.count);
+            stats->integer("error", talker.error);
+            stats->number("messages_per_s", rate);
+            stats->number("bytes_per_s", byteRate);
+            stats->end();
+        }
+    }
+
+    for (DDS::ULong i = 0; i < heap.size(); i++) {
+        heap[i].reportedCount = heap[i].count;
+        heap[i].reportedBytes = heap[i].bytes;
+    }
+    reportedTime = now;
+    out.flags(flags);
+    out.precision(precision);
+}
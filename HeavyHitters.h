@@ -0,0 +1,77 @@
+/************************************************************************
+ * LOGICAL_NAME:    HeavyHitters.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the tracking of the users that send
+ * most of the messages.
+ * 
+ ***/
+
+#ifndef __HEAVYHITTERS_H__
+#define __HEAVYHITTERS_H__
+
+#include <iostream>
+#include <vector>
+#include <tr1/unordered_map>
+
+#include "ccpp_dds_dcps.h"
+#include "StatsEmitter.h"
+
+/**
+ * A monitored user: its message count, which may overestimate the real one
+ * by at most error, and its payload since it was monitored.
+ **/
+struct Talker {
+    DDS::Long                           userID;
+    DDS::ULongLong                      count;
+    DDS::ULongLong                      error;
+    DDS::ULongLong                      bytes;
+    DDS::ULongLong                      reportedCount;  /* at the previous report */
+    DDS::ULongLong                      reportedBytes;
+};
+
+/**
+ * Space-Saving top-K: a fixed number of counters, kept in a min-heap on the
+ * count. A message of a monitored user increments its counter; one of any
+ * other user takes over the smallest counter, inheriting its count as the
+ * error. Every user sending more than 1/capacity of all messages is
+ * guaranteed to be monitored, whatever the number of users, in memory and
+ * time per message that only depend on the capacity. Used by one thread.
+ **/
+class HeavyHitters {
+
+    typedef std::tr1::unordered_map<DDS::Long, DDS::ULong> PositionMap;
+
+    std::vector<Talker>                 heap;
+    PositionMap                         position;       /* of every monitored user in the heap */
+    DDS::ULong                          capacity;
+    DDS::ULong                          shown;
+    DDS::ULongLong                      messages;
+    DDS::LongLong                       reportedTime;
+
+    /* Swap two counters, keeping the positions up to date. */
+    void swapTalkers(DDS::ULong a, DDS::ULong b);
+
+    /* Restore the heap order after a counter at i grew or was added. */
+    void siftDown(DDS::ULong i);
+    void siftUp(DDS::ULong i);
+
+public:
+    /* Constructor: capacity counters, of which the report shows the largest ones. */
+    HeavyHitters(DDS::ULong capacity, DDS::ULong shown);
+
+    /* Account for one message of the given user and payload. */
+    void record(DDS::Long userID, DDS::ULongLong bytes);
+
+    /* Copy the largest counters, largest first, into talkers. */
+    void top(DDS::ULong count, std::vector<Talker> &talkers) const;
+
+    /* Print the largest counters with their message and byte rates since the
+       previous report, and write them to stats as "talker" records if given. */
+    void report(std::ostream &out, StatsEmitter *stats);
+};
+
+#endif
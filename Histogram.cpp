@@ -0,0 +1,266 @@
+/************************************************************************
+ * LOGICAL_NAME:    Histogram.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the high-dynamic-range
+ * histogram that collects latencies and other measurements.
+ * 
+ ***/
+
+#include <iomanip>
+#include <string>
+#include <stdlib.h>
+
+#include "Histogram.h"
+#include "Atomic.h"
+
+using namespace std;
+
+#define HISTOGRAM_MAGIC "HISTOGRAM"
+#define HISTOGRAM_VERSION 1
+
+/* Returns the index of the bucket holding value. */
+static int bucketIndex(DDS::ULongLong value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return (int)value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HISTOGRAM_SUB_BITS;
+    int sub = (int)((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/* Returns the lowest value that falls into bucket index. */
+static DDS::LongLong bucketLowest(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    int sub = index % HISTOGRAM_SUB_BUCKETS;
+    return (DDS::LongLong)(HISTOGRAM_SUB_BUCKETS + sub) << shift;
+}
+
+/* Returns the highest value that falls into bucket index. */
+static DDS::LongLong bucketHighest(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    return bucketLowest(index) + ((DDS::LongLong)1 << shift) - 1;
+}
+
+Histogram::Histogram()
+{
+    reset();
+}
+
+void Histogram::record(DDS::LongLong value, DDS::ULongLong times)
+{
+    if (times == 0) {
+        return;
+    }
+    if (value < 0) {
+        value = 0;
+    }
+    __sync_fetch_and_add(&buckets[bucketIndex(value)], times);
+    __sync_fetch_and_add(&sum, value * (DDS::LongLong)times);
+
+    /* min and max only change rarely, so the compare-and-swap loops hardly ever spin. */
+    DDS::LongLong current = min;
+    while (value < current) {
+        DDS::LongLong seen = __sync_val_compare_and_swap(&min, current, value);
+        if (seen == current) {
+            break;
+        }
+        current = seen;
+    }
+    current = max;
+    while (value > current) {
+        DDS::LongLong seen = __sync_val_compare_and_swap(&max, current, value);
+        if (seen == current) {
+            break;
+        }
+        current = seen;
+    }
+
+    /* The count goes last: a snapshot never sees more values than buckets hold. */
+    __sync_fetch_and_add(&count, times);
+}
+
+void Histogram::reset()
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        buckets[i] = 0;
+    }
+    count = 0;
+    sum = 0;
+    min = 0x7fffffffffffffffLL;
+    max = 0;
+}
+
+void Histogram::snapshot(Histogram &into) const
+{
+    into.count = atomicRead(count);
+    into.sum = atomicRead(sum);
+    into.min = atomicRead(min);
+    into.max = atomicRead(max);
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into.buckets[i] = atomicRead(buckets[i]);
+    }
+}
+
+void Histogram::merge(const Histogram &other)
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    if (other.min < min) {
+        min = other.min;
+    }
+    if (other.max > max) {
+        max = other.max;
+    }
+}
+
+void Histogram::subtract(const Histogram &earlier)
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        buckets[i] -= earlier.buckets[i];
+    }
+    count -= earlier.count;
+    sum -= earlier.sum;
+    recomputeExtremes();
+}
+
+void Histogram::recomputeExtremes()
+{
+    int lowest = -1;
+    int highest = -1;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        if (buckets[i]) {
+            if (lowest < 0) {
+                lowest = i;
+            }
+            highest = i;
+        }
+    }
+    if (lowest < 0) {
+        min = 0x7fffffffffffffffLL;
+        max = 0;
+    } else {
+        /* The exact values are gone: use the bucket bounds, within the precision. */
+        min = bucketLowest(lowest);
+        max = bucketHighest(highest);
+    }
+}
+
+DDS::ULongLong Histogram::getCount() const
+{
+    return count;
+}
+
+DDS::LongLong Histogram::getMin() const
+{
+    return count ? min : 0;
+}
+
+DDS::LongLong Histogram::getMax() const
+{
+    return max;
+}
+
+double Histogram::getMean() const
+{
+    return count ? (double)sum / count : 0.0;
+}
+
+DDS::LongLong Histogram::getPercentile(double percentile) const
+{
+    DDS::ULongLong rank = (DDS::ULongLong)(percentile / 100.0 * count + 0.5);
+    DDS::ULongLong seen = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (rank == 0) {
+        return min;
+    }
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            DDS::LongLong highest = bucketHighest(i);
+            return highest < max ? highest : max;
+        }
+    }
+    return max;
+}
+
+void Histogram::print(std::ostream &out, double scale) const
+{
+    out << fixed << setprecision(1)
+        << "count " << count
+        << ", min " << getMin() / scale
+        << ", p50 " << getPercentile(50.0) / scale
+        << ", p90 " << getPercentile(90.0) / scale
+        << ", p99 " << getPercentile(99.0) / scale
+        << ", p99.9 " << getPercentile(99.9) / scale
+        << ", p99.99 " << getPercentile(99.99) / scale
+        << ", max " << getMax() / scale
+        << ", mean " << getMean() / scale;
+}
+
+void Histogram::serialize(std::ostream &out) const
+{
+    out << HISTOGRAM_MAGIC << " " << HISTOGRAM_VERSION << " " << HISTOGRAM_SUB_BITS << " "
+        << count << " " << sum << " " << getMin() << " " << max << endl;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        if (buckets[i]) {
+            out << i << " " << buckets[i] << endl;
+        }
+    }
+    out << "END" << endl;
+}
+
+bool Histogram::deserialize(std::istream &in)
+{
+    string magic;
+    int version;
+    int subBits;
+    DDS::LongLong readMin;
+
+    reset();
+    in >> magic >> version >> subBits >> count >> sum >> readMin >> max;
+    if (!in || magic != HISTOGRAM_MAGIC || version != HISTOGRAM_VERSION || subBits != HISTOGRAM_SUB_BITS) {
+        return false;
+    }
+    if (count) {
+        min = readMin;
+    }
+    for (;;) {
+        string token;
+        DDS::ULongLong bucketCount;
+
+        in >> token;
+        if (!in) {
+            return false;
+        }
+        if (token == "END") {
+            return true;
+        }
+        int index = atoi(token.c_str());
+        in >> bucketCount;
+        if (!in || index < 0 || index >= HISTOGRAM_BUCKETS) {
+            return false;
+        }
+        buckets[index] = bucketCount;
+    }
+}
@@ -0,0 +1,85 @@
+/************************************************************************
+ * LOGICAL_NAME:    Histogram.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the high-dynamic-range histogram that
+ * collects latencies and other measurements.
+ * 
+ ***/
+
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <iostream>
+
+#include "ccpp_dds_dcps.h"
+
+/**
+ * Log-linear bucketing: values below 2^HISTOGRAM_SUB_BITS are counted
+ * exactly, every higher power-of-two range is split into
+ * 2^HISTOGRAM_SUB_BITS linear sub-buckets. That bounds the relative error
+ * to 1/2^HISTOGRAM_SUB_BITS (1.6%) over the whole 63-bit range, in a fixed
+ * amount of memory.
+ **/
+#define HISTOGRAM_SUB_BITS 6
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * High-dynamic-range histogram of non-negative values. Recording is
+ * lock-free (atomic increments), so a receive thread can record while
+ * another thread takes snapshots for the periodic reports.
+ **/
+class Histogram {
+
+    DDS::ULongLong                      buckets[HISTOGRAM_BUCKETS];
+    DDS::ULongLong                      count;
+    DDS::LongLong                       sum;
+    DDS::LongLong                       min;
+    DDS::LongLong                       max;
+
+    /* Recompute min and max from the buckets, e.g. after a subtraction. */
+    void recomputeExtremes();
+
+public:
+    /* Constructor */
+    Histogram();
+
+    /* Add a value the given number of times (negative values are recorded as 0); safe from any thread. */
+    void record(DDS::LongLong value, DDS::ULongLong times = 1);
+
+    /* Forget all recorded values (not while recording). */
+    void reset();
+
+    /* Copy the current contents into another histogram, with atomic reads, so
+       while values are being recorded as well. */
+    void snapshot(Histogram &into) const;
+
+    /* Add the contents of another histogram, e.g. of another run. */
+    void merge(const Histogram &other);
+
+    /* Remove the contents of an earlier snapshot, leaving what was recorded since. */
+    void subtract(const Histogram &earlier);
+
+    DDS::ULongLong getCount() const;
+    DDS::LongLong getMin() const;
+    DDS::LongLong getMax() const;
+    double getMean() const;
+
+    /* Returns the given percentile (0-100), within the precision of the buckets. */
+    DDS::LongLong getPercentile(double percentile) const;
+
+    /* Print count, min, percentiles up to p99.99, max and mean, with the values divided by scale. */
+    void print(std::ostream &out, double scale) const;
+
+    /* Write the histogram as text, one line per non-empty bucket. */
+    void serialize(std::ostream &out) const;
+
+    /* Read a histogram written by serialize, returns false when the input is malformed. */
+    bool deserialize(std::istream &in);
+};
+
+#endif
@@ -0,0 +1,74 @@
+/************************************************************************
+ * LOGICAL_NAME:    HistogramMerge.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the 'HistogramMerge' tool,
+ * which merges the latency histograms saved by several MessageBoard runs.
+ * 
+ ***/
+
+#include <iostream>
+#include <fstream>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "Histogram.h"
+
+using namespace std;
+
+int
+main (
+    int argc,
+    char *argv[])
+{
+    static Histogram                merged;
+    static Histogram                run;
+    const char *                    outputFile = NULL;
+    int                             opt;
+
+    /* Options: HistogramMerge [-o mergedFile] histogramFile... */
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        switch (opt) {
+        case 'o':
+            outputFile = optarg;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-o mergedFile] histogramFile..." << endl;
+            exit(1);
+        }
+    }
+    if (optind >= argc) {
+        cerr << "Usage: " << argv[0] << " [-o mergedFile] histogramFile..." << endl;
+        exit(1);
+    }
+
+    for (int i = optind; i < argc; i++) {
+        ifstream in(argv[i]);
+
+        if (!in || !run.deserialize(in)) {
+            cerr << "Error in reading histogram " << argv[i] << endl;
+            exit(1);
+        }
+        cout << argv[i] << " (us): ";
+        run.print(cout, 1000.0);
+        cout << endl;
+        merged.merge(run);
+    }
+
+    cout << "merged (us): ";
+    merged.print(cout, 1000.0);
+    cout << endl;
+
+    if (outputFile) {
+        ofstream out(outputFile);
+        merged.serialize(out);
+        if (!out) {
+            cerr << "Error in writing " << outputFile << endl;
+            exit(1);
+        }
+    }
+    return 0;
+}
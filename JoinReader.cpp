@@ -0,0 +1,95 @@
+/************************************************************************
+ * LOGICAL_NAME:    JoinReader.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the reader of the joined
+ * NamedMessage samples.
+ * 
+ ***/
+
+#include <iomanip>
+
+#include "JoinReader.h"
+#include "CheckStatus.h"
+#include "Timing.h"
+
+JoinReader::JoinReader(
+    Chat::NamedMessageDataReader_ptr reader,
+    bool verbose,
+    StatusMonitor &monitor
+) : StatusReaderListener(monitor), reader(reader), received(0), verbose(verbose)
+{
+    pthread_mutex_init(&lock, NULL);
+}
+
+JoinReader::~JoinReader()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void JoinReader::takeMessages()
+{
+    DDS::ReturnCode_t status;
+
+    pthread_mutex_lock(&lock);
+
+    status = reader->take(
+        msgSeq,
+        infoSeq,
+        DDS::LENGTH_UNLIMITED,
+        DDS::ANY_SAMPLE_STATE,
+        DDS::ANY_VIEW_STATE,
+        DDS::ANY_INSTANCE_STATE );
+    checkStatus(status, "Chat::NamedMessageDataReader::take");
+
+    /* All messages of one take arrived at the same moment. */
+    DDS::LongLong now = currentTimeNanos();
+
+    for (DDS::ULong i = 0; i < msgSeq.length(); i++) {
+        if (infoSeq[i].valid_data) {
+            latency.record(now - toNanos(infoSeq[i].source_timestamp));
+            if (verbose) {
+                cout << msgSeq[i].userName << ": " << msgSeq[i].content << endl;
+            }
+            received++;
+        }
+    }
+
+    status = reader->return_loan(msgSeq, infoSeq);
+    checkStatus(status, "Chat::NamedMessageDataReader::return_loan");
+
+    pthread_mutex_unlock(&lock);
+}
+
+void JoinReader::report(std::ostream &out, const Histogram &direct)
+{
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    static const char *labels[] = { "p50", "p90", "p99", "p99.9" };
+
+    pthread_mutex_lock(&lock);
+
+    out << "Join latency (us): " << received << " NamedMessages, ";
+    latency.print(out, 1000.0);
+    out << endl;
+
+    /* What the join adds on top of reading the ChatMessages directly. */
+    if (latency.getCount() > 0 && direct.getCount() > 0) {
+        out << "  added by the join (us):";
+        for (DDS::ULong i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+            out << " " << labels[i] << " " << fixed << setprecision(1)
+                << (latency.getPercentile(percentiles[i]) - direct.getPercentile(percentiles[i])) / 1000.0;
+        }
+        out << ", mean " << fixed << setprecision(1) << (latency.getMean() - direct.getMean()) / 1000.0 << endl;
+    }
+
+    pthread_mutex_unlock(&lock);
+}
+
+void JoinReader::on_data_available (
+    DDS::DataReader_ptr reader
+) THROW_ORB_EXCEPTIONS {
+    takeMessages();
+}
@@ -0,0 +1,62 @@
+/************************************************************************
+ * LOGICAL_NAME:    JoinReader.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the reader of the joined NamedMessage
+ * samples that the simulated multitopic produces.
+ * 
+ ***/
+
+#ifndef __JOINREADER_H__
+#define __JOINREADER_H__
+
+#include <iostream>
+#include <pthread.h>
+
+#include "ccpp_dds_dcps.h"
+#include "ccpp_Chat.h"
+#include "orb_abstraction.h"
+#include "Histogram.h"
+#include "StatusMonitor.h"
+
+/**
+ * DataReaderListener that takes the NamedMessages as soon as they are
+ * available. The multitopic writes every NamedMessage with the source
+ * timestamp of the ChatMessage it was joined from, so the latency recorded
+ * here covers the original write, the join and the second hop; comparing
+ * it with the latency of the ChatMessages themselves shows what the join
+ * adds.
+ **/
+class JoinReader : public StatusReaderListener {
+
+    Chat::NamedMessageDataReader_ptr    reader;         /* owned by the MessageBoard */
+    Chat::NamedMessageSeq               msgSeq;
+    DDS::SampleInfoSeq                  infoSeq;
+    Histogram                           latency;
+    DDS::ULongLong                      received;
+    bool                                verbose;
+    pthread_mutex_t                     lock;
+
+public:
+    /* Constructor */
+    JoinReader(Chat::NamedMessageDataReader_ptr reader, bool verbose, StatusMonitor &monitor);
+
+    /* Destructor */
+    virtual ~JoinReader();
+
+    /* Take and process all available NamedMessages. */
+    void takeMessages();
+
+    /* Print the join latency next to the direct one, in microseconds. */
+    void report(std::ostream &out, const Histogram &direct);
+
+    /* Callback method implementation. */
+    virtual void on_data_available (
+        DDS::DataReader_ptr reader
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+#endif
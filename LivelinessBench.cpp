@@ -0,0 +1,429 @@
+/************************************************************************
+ * LOGICAL_NAME:    LivelinessBench.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the 'LivelinessBench'
+ * executable, which measures how long a reader takes to see the alive_count
+ * of a writer drop, as the UserLoad does to find the users that left, for
+ * the liveliness kinds and lease durations given.
+ * 
+ ***/
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "ccpp_dds_dcps.h"
+#include "CheckStatus.h"
+#include "ccpp_Chat.h"
+#include "Histogram.h"
+#include "Timing.h"
+
+#define REPETITIONS 5
+#define STARTUP_TIMEOUT 30.0        /* s for a writer to become alive */
+#define DETECTION_SLACK 10.0        /* s to wait beyond ten leases for the drop */
+
+using namespace DDS;
+using namespace Chat;
+
+/* Set by SIGUSR1 in a writer process: stop asserting liveliness. */
+static volatile sig_atomic_t stopAsserting = 0;
+
+extern "C" void
+onStop(
+    int signum)
+{
+    stopAsserting = 1;
+}
+
+/**
+ * Returns the liveliness kind for "automatic", "participant" or "topic";
+ * exits when the name is unknown.
+ **/
+static LivelinessQosPolicyKind
+livelinessKind(const char *name)
+{
+    if (strcmp(name, "automatic") == 0) {
+        return AUTOMATIC_LIVELINESS_QOS;
+    } else if (strcmp(name, "participant") == 0) {
+        return MANUAL_BY_PARTICIPANT_LIVELINESS_QOS;
+    } else if (strcmp(name, "topic") == 0) {
+        return MANUAL_BY_TOPIC_LIVELINESS_QOS;
+    }
+    cerr << "Unknown liveliness kind: " << name << endl;
+    exit(-1);
+}
+
+/**
+ * Registers the ChatMessage type and creates the topic shared by the
+ * benchmark and its writer processes: of its own, with the default QoS, so
+ * that no chat is disturbed.
+ **/
+static Topic_ptr
+createBenchTopic(DomainParticipant_ptr participant, char *&typeName)
+{
+    ChatMessageTypeSupport_var      chatMessageTS;
+    Topic_ptr                       topic;
+    ReturnCode_t                    status;
+
+    chatMessageTS = new ChatMessageTypeSupport();
+    checkHandle(chatMessageTS.in(), "new ChatMessageTypeSupport");
+    typeName = chatMessageTS->get_type_name();
+    status = chatMessageTS->register_type(participant, typeName);
+    checkStatus(status, "Chat::ChatMessageTypeSupport::register_type");
+
+    topic = participant->create_topic(
+        "Bench_Liveliness",
+        typeName,
+        TOPIC_QOS_DEFAULT,
+        NULL,
+        STATUS_MASK_NONE);
+    checkHandle(topic, "DDS::DomainParticipant::create_topic (Liveliness)");
+    return topic;
+}
+
+/**
+ * The writer process: offers the liveliness kind and lease given, writes
+ * once and asserts its liveliness four times per lease, as a manual kind
+ * requires, until SIGUSR1 tells it to stop. It never leaves by itself; the
+ * benchmark kills it.
+ **/
+static void
+runWriter(const char *kindName, double lease)
+{
+    DomainParticipantFactory_var    dpf;
+    DomainParticipant_var           participant;
+    Topic_var                       topic;
+    Publisher_var                   publisher;
+    DataWriter_ptr                  parentWriter;
+    ChatMessageDataWriter_var       talker;
+    PublisherQos                    pub_qos;
+    DataWriterQos                   dw_qos;
+    DomainId_t                      domain = NULL;
+    ReturnCode_t                    status;
+    char                            *typeName = NULL;
+    ChatMessage                     msg;
+    LivelinessQosPolicyKind         kind = livelinessKind(kindName);
+
+    signal(SIGUSR1, onStop);
+
+    dpf = DomainParticipantFactory::get_instance();
+    checkHandle(dpf.in(), "DDS::DomainParticipantFactory::get_instance");
+    participant = dpf->create_participant(domain, PARTICIPANT_QOS_DEFAULT, NULL, STATUS_MASK_NONE);
+    checkHandle(participant.in(), "DDS::DomainParticipantFactory::create_participant");
+    topic = createBenchTopic(participant.in(), typeName);
+
+    status = participant->get_default_publisher_qos(pub_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_publisher_qos");
+    pub_qos.partition.name.length(1);
+    pub_qos.partition.name[0] = "LivelinessBench";
+    publisher = participant->create_publisher(pub_qos, NULL, STATUS_MASK_NONE);
+    checkHandle(publisher.in(), "DDS::DomainParticipant::create_publisher");
+
+    /* The liveliness is offered by the writer; the topic keeps the default. */
+    status = publisher->get_default_datawriter_qos(dw_qos);
+    checkStatus(status, "DDS::Publisher::get_default_datawriter_qos");
+    dw_qos.liveliness.kind = kind;
+    dw_qos.liveliness.lease_duration = toDuration(secondsToNanos(lease));
+    parentWriter = publisher->create_datawriter(topic.in(), dw_qos, NULL, STATUS_MASK_NONE);
+    checkHandle(parentWriter, "DDS::Publisher::create_datawriter (Liveliness)");
+    talker = ChatMessageDataWriter::_narrow(parentWriter);
+    checkHandle(talker.in(), "Chat::ChatMessageDataWriter::_narrow");
+
+    msg.userID = getpid();
+    msg.index = 0;
+    msg.content = string_dup("Liveliness benchmark.");
+    status = talker->write(msg, HANDLE_NIL);
+    checkStatus(status, "Chat::ChatMessageDataWriter::write");
+
+    while (!stopAsserting) {
+        if (kind == MANUAL_BY_PARTICIPANT_LIVELINESS_QOS) {
+            status = participant->assert_liveliness();
+            checkStatus(status, "DDS::DomainParticipant::assert_liveliness");
+        } else if (kind == MANUAL_BY_TOPIC_LIVELINESS_QOS) {
+            status = talker->assert_liveliness();
+            checkStatus(status, "DDS::DataWriter::assert_liveliness");
+        }
+        usleep((useconds_t)(lease * 1.0E6 / 4));
+    }
+    for (;;) {
+        pause();
+    }
+}
+
+/**
+ * Waits until the alive_count of the reader is above (up) or below the
+ * given count, and returns the time at which that was seen, or 0 when the
+ * deadline passed first.
+ **/
+static LongLong
+waitForAliveCount(
+    WaitSet_ptr waitSet,
+    DataReader_ptr reader,
+    bool up,
+    Long count,
+    LongLong deadline)
+{
+    ConditionSeq                    guardList;
+    LivelinessChangedStatus         livChangStatus;
+    ReturnCode_t                    status;
+    LongLong                        now;
+
+    for (;;) {
+        now = currentTimeNanos();
+        status = reader->get_liveliness_changed_status(livChangStatus);
+        checkStatus(status, "DDS::DataReader::get_liveliness_changed_status");
+        if (up ? livChangStatus.alive_count > count : livChangStatus.alive_count < count) {
+            return now;
+        }
+        if (now >= deadline) {
+            return 0;
+        }
+        status = waitSet->wait(guardList, toDuration(deadline - now));
+        if (status != RETCODE_TIMEOUT) {
+            checkStatus(status, "DDS::WaitSet::wait");
+        }
+    }
+}
+
+int
+main (
+    int argc,
+    char *argv[])
+{
+    /* Generic DDS entities */
+    DomainParticipantFactory_var    dpf;
+    DomainParticipant_var           participant;
+    Topic_var                       topic;
+    Subscriber_var                  subscriber;
+    DataReader_var                  reader;
+    StatusCondition_var             livelinessChanged;
+    WaitSet_var                     waitSet;
+
+    /* QosPolicy holders */
+    SubscriberQos                   sub_qos;
+
+    /* DDS Identifiers */
+    DomainId_t                      domain = NULL;
+    ReturnCode_t                    status;
+    LivelinessChangedStatus         livChangStatus;
+
+    /* Others */
+    char                            *typeName = NULL;
+    std::vector<double>             leases;
+    std::vector<const char *>       kinds;
+    std::vector<const char *>       modes;
+    int                             repetitions = REPETITIONS;
+    bool                            writer = false;
+    int                             opt;
+
+    /* Options: LivelinessBench [-k automatic|participant|topic]... [-l leaseSeconds]...
+                                [-m kill|stop]... [-n repetitions] */
+    /* Every combination of the kinds, leases and modes given is measured;
+       without, all kinds, leases of 0.5, 1 and 2 s and both modes. A writer
+       is killed with SIGKILL, or stops asserting its liveliness; the latter
+       only for the manual kinds. -w runs as the writer process itself. */
+    while ((opt = getopt(argc, argv, "k:l:m:n:w")) != -1) {
+        switch (opt) {
+        case 'k':
+            livelinessKind(optarg);
+            kinds.push_back(optarg);
+            break;
+        case 'l':
+            leases.push_back(atof(optarg));
+            break;
+        case 'm':
+            if (strcmp(optarg, "kill") != 0 && strcmp(optarg, "stop") != 0) {
+                cerr << "Unknown mode: " << optarg << endl;
+                exit(-1);
+            }
+            modes.push_back(optarg);
+            break;
+        case 'n':
+            repetitions = atoi(optarg);
+            break;
+        case 'w':
+            writer = true;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-k automatic|participant|topic]... [-l leaseSeconds]... [-m kill|stop]... [-n repetitions]" << endl;
+            exit(1);
+        }
+    }
+    if (kinds.empty()) {
+        kinds.push_back("automatic");
+        kinds.push_back("participant");
+        kinds.push_back("topic");
+    }
+    if (leases.empty()) {
+        leases.push_back(0.5);
+        leases.push_back(1.0);
+        leases.push_back(2.0);
+    }
+    if (modes.empty()) {
+        modes.push_back("kill");
+        modes.push_back("stop");
+    }
+    for (ULong l = 0; l < leases.size(); l++) {
+        if (leases[l] <= 0) {
+            cerr << "The lease durations must be positive." << endl;
+            exit(-1);
+        }
+    }
+    if (writer) {
+        runWriter(kinds[0], leases[0]);
+    }
+
+    /* Create a DomainParticipantFactory and a DomainParticipant (using Default QoS settings. */
+    dpf = DomainParticipantFactory::get_instance();
+    checkHandle(dpf.in(), "DDS::DomainParticipantFactory::get_instance");
+    participant = dpf->create_participant(domain, PARTICIPANT_QOS_DEFAULT, NULL, STATUS_MASK_NONE);
+    checkHandle(participant.in(), "DDS::DomainParticipantFactory::create_participant");
+    topic = createBenchTopic(participant.in(), typeName);
+
+    /* A Subscriber in a Partition of its own. */
+    status = participant->get_default_subscriber_qos(sub_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_subscriber_qos");
+    sub_qos.partition.name.length(1);
+    sub_qos.partition.name[0] = "LivelinessBench";
+    subscriber = participant->create_subscriber(sub_qos, NULL, STATUS_MASK_NONE);
+    checkHandle(subscriber.in(), "DDS::DomainParticipant::create_subscriber");
+
+    /* The reader requests AUTOMATIC liveliness with an infinite lease, which every writer satisfies. */
+    reader = subscriber->create_datareader(topic.in(), DATAREADER_QOS_USE_TOPIC_QOS, NULL, STATUS_MASK_NONE);
+    checkHandle(reader.in(), "DDS::Subscriber::create_datareader (Liveliness)");
+
+    /* Wake up on liveliness changes only, as the UserLoad does. */
+    livelinessChanged = reader->get_statuscondition();
+    checkHandle(livelinessChanged.in(), "DDS::DataReader::get_statuscondition");
+    status = livelinessChanged->set_enabled_statuses(LIVELINESS_CHANGED_STATUS);
+    checkStatus(status, "DDS::StatusCondition::set_enabled_statuses");
+    waitSet = new WaitSet();
+    status = waitSet->attach_condition(livelinessChanged.in());
+    checkStatus(status, "DDS::WaitSet::attach_condition (livelinessChanged)");
+
+    cout << "Liveliness-loss detection, " << repetitions << " repetitions, in ms:" << endl;
+    for (ULong k = 0; k < kinds.size(); k++) {
+        for (ULong l = 0; l < leases.size(); l++) {
+            for (ULong m = 0; m < modes.size(); m++) {
+                bool stop = strcmp(modes[m], "stop") == 0;
+                Histogram detection;
+                ostringstream leaseText;
+                bool lingering = false;         /* a writer that never left ended the repetitions */
+
+                /* An AUTOMATIC writer is kept alive by the service; it cannot stop. */
+                if (stop && livelinessKind(kinds[k]) == AUTOMATIC_LIVELINESS_QOS) {
+                    continue;
+                }
+                leaseText << leases[l];
+
+                for (int r = 0; r < repetitions; r++) {
+                    LongLong alive;
+                    LongLong start;
+                    LongLong lost;
+                    LongLong deadline;
+                    pid_t pid;
+
+                    status = reader->get_liveliness_changed_status(livChangStatus);
+                    checkStatus(status, "DDS::DataReader::get_liveliness_changed_status");
+
+                    /* A process of its own, started afresh, so that it can be killed. */
+                    pid = fork();
+                    if (pid < 0) {
+                        cerr << "Error in starting a writer process" << endl;
+                        exit(-1);
+                    } else if (pid == 0) {
+                        execlp(argv[0], argv[0], "-w", "-k", kinds[k], "-l", leaseText.str().c_str(), (char *)NULL);
+                        cerr << "Error in running " << argv[0] << " as a writer" << endl;
+                        _exit(-1);
+                    }
+
+                    alive = waitForAliveCount(
+                        waitSet.in(),
+                        reader.in(),
+                        true,
+                        livChangStatus.alive_count,
+                        currentTimeNanos() + secondsToNanos(STARTUP_TIMEOUT));
+                    if (alive == 0) {
+                        cerr << "The writer did not become alive" << endl;
+                        kill(pid, SIGKILL);
+                        exit(-1);
+                    }
+
+                    /* Let it assert for a while, then end it at a known time. */
+                    sleepUntilNanos(alive + 2 * secondsToNanos(leases[l]));
+                    status = reader->get_liveliness_changed_status(livChangStatus);
+                    checkStatus(status, "DDS::DataReader::get_liveliness_changed_status");
+                    start = currentTimeNanos();
+                    kill(pid, stop ? SIGUSR1 : SIGKILL);
+
+                    deadline = start + 10 * secondsToNanos(leases[l]) + secondsToNanos(DETECTION_SLACK);
+                    lost = waitForAliveCount(
+                        waitSet.in(),
+                        reader.in(),
+                        false,
+                        livChangStatus.alive_count,
+                        deadline);
+                    if (lost == 0) {
+                        cerr << "No loss of liveliness seen for " << kinds[k] << ", lease "
+                             << leases[l] << " s, " << modes[m] << endl;
+                    } else {
+                        detection.record(lost - start);
+                    }
+
+                    /* The writer is gone for the next repetition. */
+                    kill(pid, SIGKILL);
+                    waitpid(pid, NULL, 0);
+                    if (lost == 0) {
+                        /* The deadline above has passed: wait afresh, or its late drop lands in the next repetition. */
+                        deadline = currentTimeNanos() + 10 * secondsToNanos(leases[l]) + secondsToNanos(DETECTION_SLACK);
+                        if (waitForAliveCount(waitSet.in(), reader.in(), false, livChangStatus.alive_count, deadline) == 0) {
+                            cerr << "The writer did not leave for " << kinds[k] << ", lease "
+                                 << leases[l] << " s, " << modes[m] << "; no further repetitions" << endl;
+                            lingering = true;
+                            break;
+                        }
+                    }
+                }
+
+                cout << setw(12) << kinds[k] << " lease " << setw(4) << leases[l]
+                     << " s " << setw(5) << modes[m] << ": ";
+                detection.print(cout, 1.0E6);
+                if (detection.getCount() > 0) {
+                    cout << ", p50/lease " << setprecision(2)
+                         << detection.getPercentile(50.0) / (double)secondsToNanos(leases[l]);
+                }
+                if (lingering) {
+                    cout << " (incomplete: a writer did not leave)";
+                }
+                cout << endl;
+            }
+        }
+    }
+
+    /* Remove the Condition from the WaitSet. */
+    status = waitSet->detach_condition(livelinessChanged.in());
+    checkStatus(status, "DDS::WaitSet::detach_condition (livelinessChanged)");
+
+    /* Remove the type-name. */
+    string_free(typeName);
+
+    /* Free all resources */
+    status = participant->delete_contained_entities();
+    checkStatus(status, "DDS::DomainParticipant::delete_contained_entities");
+    status = dpf->delete_participant(participant.in());
+    checkStatus(status, "DDS::DomainParticipantFactory::delete_participant");
+
+    return 0;
+}
@@ -22,26 +22,53 @@
  ***/
  
 #include <iostream>
+#include <fstream>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <iomanip>
+#include <vector>
 
 #include "ccpp_dds_dcps.h"
 #include "CheckStatus.h"
 #include "ccpp_Chat.h"
 #include "multitopic.h"
+#include "ChatReceiver.h"
+#include "FanOut.h"
+#include "JoinReader.h"
+#include "CaptureLog.h"
+#include "StatsEmitter.h"
+#include "StatusMonitor.h"
+#include "Timing.h"
 
 using namespace DDS;
 using namespace Chat;
 
 
 
-#define TERMINATION_MESSAGE -1 
+#define DRAIN_TIMEOUT 2.0
+#define MAX_BATCH 256
+#define LATENCY_TARGET 1000.0        /* us */
+#define REPORT_PERIOD 10.0
+#define POLL_PERIOD 100000000LL     /* ns */
+#define WORK_COST 0.0               /* us */
+#define QUEUE_DEPTH 4096            /* items per worker */
+#define CAPTURE_SIZE 64             /* MB */
 
 void printTopicQos(DDS::TopicQos topicQos);
 void printReaderQos(DDS::DataReaderQos readerQos);
 void printWriterQos(DDS::DataWriterQos readerQos);
-void printCurrentTime(DDS::DomainParticipant &participant);
+void pollingLoop(ChatReceiver &receiver);
+void waitSetLoop(
+    ChatReceiver &receiver,
+    ChatMessageDataReader_ptr chatAdmin,
+    RunControlDataReader_ptr controlAdmin);
+void listenerLoop(
+    ChatReceiver &receiver,
+    ChatMessageDataReader_ptr chatAdmin,
+    RunControlDataReader_ptr controlAdmin,
+    StatusMonitor &monitor);
+void spinLoop(ChatReceiver &receiver);
 
 
 int
@@ -56,16 +83,21 @@ main (
     Topic_var                       chatMessageTopic;
     Topic_var                       nameServiceTopic;
     TopicDescription_var            namedMessageTopic;
+    Topic_var                       runControlTopic;
+    ContentFilteredTopic_var        ownFilterTopic;
     Subscriber_var                  chatSubscriber;
     DataReader_ptr                  parentReader;
+    std::vector<Subscriber_ptr>     fanOutSubscribers;
 
     /* Type-specific DDS entities */
     ChatMessageTypeSupport_var      chatMessageTS;
     NameServiceTypeSupport_var      nameServiceTS;
     NamedMessageTypeSupport_var     namedMessageTS;
     ChatMessageDataReader_var      chatAdmin;
-    ChatMessageSeq_var             msgSeq = new ChatMessageSeq();
-    SampleInfoSeq_var               infoSeq = new SampleInfoSeq();
+    RunControlDataReader_var        controlAdmin;
+    NamedMessageDataReader_var      joinAdmin;
+    std::vector<ChatMessageDataReader_ptr> fanOutReaders;
+    std::vector<FanOutReader *>     fanOutListeners;
 
     /* QosPolicy holders */
     TopicQos                        reliable_topic_qos;
@@ -78,23 +110,166 @@ main (
     ReturnCode_t                    status;
 
     /* Others */
-    bool                            terminated = FALSE;
     const char *                    partitionName = "ChatRoom";
     char  *                         chatMessageTypeName = NULL;
     char  *                         nameServiceTypeName = NULL;
     char  *                         namedMessageTypeName = NULL;
-
-#ifdef USE_NANOSLEEP
-    struct timespec                 sleeptime;
-    struct timespec                 remtime;
-#endif
-
-    /* Options: MessageBoard [ownID] */
+    double                          drainTimeout = DRAIN_TIMEOUT;
+    const char *                    receiveMode = "waitset";
+    Long                            maxBatch = MAX_BATCH;
+    double                          latencyTarget = LATENCY_TARGET;
+    double                          reportPeriod = REPORT_PERIOD;
+    bool                            verbose = false;
+    const char *                    histogramFile = NULL;
+    Long                            workers = 0;
+    double                          workCost = WORK_COST;
+    Long                            queueDepth = QUEUE_DEPTH;
+    Long                            readers = 1;
+    Long                            subscribers = 1;
+    ArrivalSkew *                   skew = NULL;
+    LongLong                        residentBefore;
+    LongLong                        residentAfter;
+    bool                            join = false;
+    const char *                    filterName = "none";
+    FilterKind                      filter;
+    JoinReader *                    joinListener = NULL;
+    StatusMonitor                   monitor;
+    StatusReaderListener *          readerStatus;
+    const char *                    captureFile = NULL;
+    Long                            captureSize = CAPTURE_SIZE;
+    CaptureLog *                    capture = NULL;
+    const char *                    statsTarget = NULL;
+    StatsEmitter *                  stats = NULL;
+    ReceiverOptions                 receiverOptions;
+    int                             opt;
+
+    /* Options: MessageBoard [-m poll|waitset|listener|spin] [-d drainTimeout]
+                             [-b maxBatch] [-t latencyTarget] [-r reportPeriod]
+                             [-H histogramFile] [-P workers] [-w workCost]
+                             [-q queueDepth] [-R readers] [-S subscribers] [-j]
+                             [-f none|cft|query|ignore|app]
+                             [-c captureFile] [-C captureSize]
+                             [-J statsFile|fd:N] [-v] [ownID] */
     /* Messages having owner ownID will be ignored */
+    /* A maxBatch of 0 takes everything at once; latencyTarget is in us. */
+    /* A reportPeriod of 0 only reports at the end; -v prints every message. */
+    /* With -P the messages are processed by a pool of workers, the messages of
+       one user by one worker in order; workCost is the synthetic work per
+       message in us. A worker holds at most queueDepth messages; taking
+       waits until it has room for more. */
+    /* With -R every message is delivered to that many ChatMessage readers,
+       spread over -S Subscribers; the additional ones use listeners. */
+    /* With -j the ChatMessages are also joined with the NameService into
+       NamedMessages by the simulated multitopic, and those are read too. */
+    /* -f selects where the messages of ownID are filtered out: in the
+       middleware (ContentFilteredTopic), when taking (QueryCondition), by
+       ignoring their publications (participant-wide, so not with -R or -j),
+       or in the application. */
+    /* With -c every message taken is recorded in captureFile, a ring of
+       captureSize MB that keeps the most recent ones; CaptureDump converts
+       it to CSV. */
+    /* With -J the statistics of every report and of the whole run are also
+       written as JSON lines, to a file or an open file descriptor. */
+    while ((opt = getopt(argc, argv, "m:d:b:t:r:H:P:w:q:R:S:jf:c:C:J:v")) != -1) {
+        switch (opt) {
+        case 'm':
+            receiveMode = optarg;
+            break;
+        case 'd':
+            drainTimeout = atof(optarg);
+            break;
+        case 'b':
+            maxBatch = atoi(optarg);
+            break;
+        case 't':
+            latencyTarget = atof(optarg);
+            break;
+        case 'r':
+            reportPeriod = atof(optarg);
+            break;
+        case 'H':
+            histogramFile = optarg;
+            break;
+        case 'P':
+            workers = atoi(optarg);
+            break;
+        case 'w':
+            workCost = atof(optarg);
+            break;
+        case 'q':
+            queueDepth = atoi(optarg);
+            break;
+        case 'R':
+            readers = atoi(optarg);
+            break;
+        case 'S':
+            subscribers = atoi(optarg);
+            break;
+        case 'j':
+            join = true;
+            break;
+        case 'f':
+            filterName = optarg;
+            break;
+        case 'c':
+            captureFile = optarg;
+            break;
+        case 'C':
+            captureSize = atoi(optarg);
+            break;
+        case 'J':
+            statsTarget = optarg;
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-m poll|waitset|listener|spin] [-d drainTimeout]"
+                 << " [-b maxBatch] [-t latencyTarget] [-r reportPeriod]"
+                 << " [-H histogramFile] [-P workers] [-w workCost]"
+                 << " [-q queueDepth] [-R readers] [-S subscribers] [-j]"
+                 << " [-f none|cft|query|ignore|app]"
+                 << " [-c captureFile] [-C captureSize]"
+                 << " [-J statsFile|fd:N] [-v] [ownID]" << endl;
+            exit(1);
+        }
+    }
+    if (strcmp(filterName, "none") == 0) {
+        filter = FILTER_NONE;
+    } else if (strcmp(filterName, "cft") == 0) {
+        filter = FILTER_CFT;
+    } else if (strcmp(filterName, "query") == 0) {
+        filter = FILTER_QUERY;
+    } else if (strcmp(filterName, "ignore") == 0) {
+        filter = FILTER_IGNORE;
+    } else if (strcmp(filterName, "app") == 0) {
+        filter = FILTER_APP;
+    } else {
+        cerr << "Unknown filter: " << filterName << endl;
+        exit(1);
+    }
+    if (readers < 1 || subscribers < 1) {
+        cerr << "At least one reader and one subscriber are needed." << endl;
+        exit(1);
+    }
+    if (filter == FILTER_IGNORE && (readers > 1 || join)) {
+        /* Ignoring a publication is participant-wide: it would also silence
+           the additional readers and the join. */
+        cerr << "Filter ignore only works with a single reader and without -j." << endl;
+        exit(1);
+    }
+    if (queueDepth <= 0) {
+        cerr << "The queue depth must be positive." << endl;
+        exit(1);
+    }
+    if (captureSize <= 0) {
+        cerr << "The capture size must be a positive number of MB." << endl;
+        exit(1);
+    }
     parameterList.length(1);
     
-    if (argc > 1) {
-        parameterList[0] = string_dup(argv[1]);
+    if (optind < argc) {
+        parameterList[0] = string_dup(argv[optind]);
     }
     else
     {
@@ -163,6 +338,9 @@ main (
         STATUS_MASK_NONE);
     checkHandle(chatMessageTopic.in(), "DDS::DomainParticipant::create_topic (ChatMessage)");
 
+    /* Create the RunControl Topic on which the Chatters announce their runs. */
+    runControlTopic = createRunControlTopic(participant.in());
+
     /* Adapt the default SubscriberQos to read from the "ChatRoom" Partition. */
     status = participant->get_default_subscriber_qos (sub_qos);
     checkStatus(status, "DDS::DomainParticipant::get_default_subscriber_qos");
@@ -173,12 +351,28 @@ main (
     chatSubscriber = participant->create_subscriber(sub_qos, NULL, STATUS_MASK_NONE);
     checkHandle(chatSubscriber.in(), "DDS::DomainParticipant::create_subscriber");
     
-    /* Create a DataReader for the NamedMessage Topic (using the appropriate QoS). */
+    /* Let the middleware filter out the messages of ownID. */
+    if (filter == FILTER_CFT) {
+        ownFilterTopic = participant->create_contentfilteredtopic(
+            "Chat_OthersMessage", 
+            chatMessageTopic.in(),
+            "userID <> %0",
+            parameterList);
+        checkHandle(ownFilterTopic.in(), "DDS::DomainParticipant::create_contentfilteredtopic");
+    }
+
+    /* All DataReaders count lost and rejected samples, missed deadlines and incompatible QoS. */
+    readerStatus = new StatusReaderListener(monitor);
+    checkHandle(readerStatus, "new StatusReaderListener");
+
+    /* Create a DataReader for the ChatMessage Topic (using the appropriate QoS). */
     parentReader = chatSubscriber->create_datareader( 
-        chatMessageTopic.in(), 
+        filter == FILTER_CFT ? 
+            (TopicDescription_ptr)ownFilterTopic.in() : 
+            (TopicDescription_ptr)chatMessageTopic.in(), 
         DATAREADER_QOS_USE_TOPIC_QOS, 
-        NULL,
-        STATUS_MASK_NONE);
+        readerStatus,
+        MONITORED_READER_STATUS);
     DDS::DataReaderQos dr_qos;
     status = parentReader->get_qos(dr_qos);
     checkStatus(status, "DDS::DataReader::get_default_datareader_qos");
@@ -191,62 +385,231 @@ main (
     chatAdmin = Chat::ChatMessageDataReader::_narrow(parentReader);
     checkHandle(chatAdmin.in(), "Chat::NamedMessageDataReader::_narrow");
     
+    /* Create a DataReader for the RunControl Topic (using the appropriate QoS). */
+    parentReader = chatSubscriber->create_datareader( 
+        runControlTopic.in(), 
+        DATAREADER_QOS_USE_TOPIC_QOS, 
+        readerStatus,
+        MONITORED_READER_STATUS);
+    checkHandle(parentReader, "DDS::Subscriber::create_datareader (RunControl)");
+
+    /* Narrow the abstract parent into its typed representative. */
+    controlAdmin = Chat::RunControlDataReader::_narrow(parentReader);
+    checkHandle(controlAdmin.in(), "Chat::RunControlDataReader::_narrow");
+
+    /* Create the additional Subscribers and ChatMessage readers, round-robin. */
+    residentBefore = residentBytes();
+    if (readers > 1) {
+        skew = new ArrivalSkew(readers);
+    }
+    for (Long i = 1; i < subscribers; i++) {
+        Subscriber_ptr subscriber = participant->create_subscriber(sub_qos, NULL, STATUS_MASK_NONE);
+        checkHandle(subscriber, "DDS::DomainParticipant::create_subscriber (fan-out)");
+        fanOutSubscribers.push_back(subscriber);
+    }
+    for (Long i = 1; i < readers; i++) {
+        Subscriber_ptr subscriber = (i % subscribers == 0) ?
+            chatSubscriber.in() : fanOutSubscribers[i % subscribers - 1];
+
+        parentReader = subscriber->create_datareader( 
+            chatMessageTopic.in(), 
+            DATAREADER_QOS_USE_TOPIC_QOS, 
+            NULL,
+            STATUS_MASK_NONE);
+        checkHandle(parentReader, "DDS::Subscriber::create_datareader (fan-out)");
+        ChatMessageDataReader_ptr reader = Chat::ChatMessageDataReader::_narrow(parentReader);
+        checkHandle(reader, "Chat::ChatMessageDataReader::_narrow (fan-out)");
+        fanOutReaders.push_back(reader);
+
+        FanOutReader *listener = new FanOutReader(reader, *skew, monitor);
+        checkHandle(listener, "new FanOutReader");
+        status = reader->set_listener(listener, DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
+        checkStatus(status, "DDS::DataReader::set_listener (fan-out)");
+        fanOutListeners.push_back(listener);
+
+        /* Data that arrived before the listener was attached does not trigger it. */
+        listener->takeMessages();
+    }
+    residentAfter = residentBytes();
+
+    if (join) {
+        /* Set the DurabilityQosPolicy to TRANSIENT. */
+        status = participant->get_default_topic_qos(setting_topic_qos);
+        checkStatus(status, "DDS::DomainParticipant::get_default_topic_qos");
+        setting_topic_qos.durability.kind = TRANSIENT_DURABILITY_QOS;
+
+        /* Create the NameService Topic, the other half of the join. */
+        nameServiceTopic = participant->create_topic( 
+            "Chat_NameService", 
+            nameServiceTypeName, 
+            setting_topic_qos, 
+            NULL,
+            STATUS_MASK_NONE);
+        checkHandle(nameServiceTopic.in(), "DDS::DomainParticipant::create_topic (NameService)");
+
+        /* Create the simulated multitopic, which skips the messages of ownID. */
+        namedMessageTopic = participant->create_simulated_multitopic(
+            "Chat_NamedMessage", 
+            namedMessageTypeName, 
+            "SELECT * FROM Chat_ChatMessage NATURAL JOIN Chat_NameService WHERE userID <> %0", 
+            parameterList);
+        checkHandle(namedMessageTopic.in(), "DDS::ExtDomainParticipant::create_simulated_multitopic");
+
+        /* Create a DataReader for the NamedMessage Topic (using the appropriate QoS). */
+        parentReader = chatSubscriber->create_datareader( 
+            namedMessageTopic.in(), 
+            DATAREADER_QOS_USE_TOPIC_QOS, 
+            NULL,
+            STATUS_MASK_NONE);
+        checkHandle(parentReader, "DDS::Subscriber::create_datareader (NamedMessage)");
+
+        /* Narrow the abstract parent into its typed representative. */
+        joinAdmin = Chat::NamedMessageDataReader::_narrow(parentReader);
+        checkHandle(joinAdmin.in(), "Chat::NamedMessageDataReader::_narrow");
+
+        /* The joined messages are taken by a listener, next to the direct ones. */
+        joinListener = new JoinReader(joinAdmin.in(), verbose, monitor);
+        checkHandle(joinListener, "new JoinReader");
+        status = joinAdmin->set_listener(joinListener, DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
+        checkStatus(status, "DDS::DataReader::set_listener (NamedMessage)");
+        joinListener->takeMessages();
+    }
+
+    /* The receiver takes and processes the data, whichever mode wakes it up. */
+    receiverOptions.drainTimeout = secondsToNanos(drainTimeout);
+    receiverOptions.maxBatch = maxBatch;
+    receiverOptions.latencyTarget = secondsToNanos(latencyTarget / 1.0E6);
+    receiverOptions.reportPeriod = secondsToNanos(reportPeriod);
+    receiverOptions.verbose = verbose;
+    receiverOptions.workers = workers > 0 ? workers : 0;
+    receiverOptions.queueDepth = queueDepth;
+    receiverOptions.workCost = secondsToNanos(workCost / 1.0E6);
+    receiverOptions.skew = skew;
+    receiverOptions.monitor = &monitor;
+    receiverOptions.filter = filter;
+    receiverOptions.ownID = atoi(parameterList[0]);
+    receiverOptions.participant = participant.in();
+    if (captureFile) {
+        capture = new CaptureLog(captureFile, (ULongLong)captureSize * 1048576);
+    }
+    receiverOptions.capture = capture;
+    if (statsTarget) {
+        stats = new StatsEmitter(statsTarget, "MessageBoard");
+    }
+    receiverOptions.stats = stats;
+    ChatReceiver receiver(chatAdmin.in(), controlAdmin.in(), receiverOptions);
+    if (join) {
+        receiver.addProfile(participant->get_simulated_multitopic_profile());
+    }
+
     /* Print a message that the MessageBoard has opened. */
-    cout << "MessageBoard has opened: send a ChatMessage with userID = -1 to close it...." << endl << endl;
-
-    while (!terminated) {
-        /* Note: using read does not remove the samples from
-           unregistered instances from the DataReader. This means
-           that the DataRase would use more and more resources.
-           That's why we use take here instead. */
-
-        status = chatAdmin->take( 
-            msgSeq, 
-            infoSeq, 
-            LENGTH_UNLIMITED, 
-            ANY_SAMPLE_STATE, 
-            ANY_VIEW_STATE, 
-            ALIVE_INSTANCE_STATE );
-        checkStatus(status, "Chat::ChatMessageDataReader::take");
-
-        for (ULong i = 0; i < msgSeq->length(); i++) {
-            ChatMessage *msg = &(msgSeq[i]);
-            if (msg->userID == TERMINATION_MESSAGE) {
-                cout << "Termination message received: exiting..." << endl;
-                terminated = TRUE;
-            } else {
-		printCurrentTime(*participant);
-                cout << msg->content << endl;
-            }
+    cout << "MessageBoard has opened (" << receiveMode << " mode): "
+         << "it closes when all announced runs have ended and drained...." << endl << endl;
+
+    if (strcmp(receiveMode, "poll") == 0) {
+        pollingLoop(receiver);
+    } else if (strcmp(receiveMode, "waitset") == 0) {
+        waitSetLoop(receiver, chatAdmin.in(), controlAdmin.in());
+    } else if (strcmp(receiveMode, "listener") == 0) {
+        listenerLoop(receiver, chatAdmin.in(), controlAdmin.in(), monitor);
+    } else if (strcmp(receiveMode, "spin") == 0) {
+        spinLoop(receiver);
+    } else {
+        cerr << "Unknown receive mode: " << receiveMode << endl;
+        exit(1);
+    }
+
+    cout << "All announced runs have drained: exiting..." << endl;
+    receiver.finish();
+    receiver.report(cout);
+
+    /* Per-reader latency, the skew between the readers and what they cost in memory. */
+    if (skew) {
+        for (ULong i = 0; i < fanOutListeners.size(); i++) {
+            cout << "Reader " << i + 1 << ": ";
+            fanOutListeners[i]->report(cout);
+        }
+        skew->report(cout);
+    }
+    if (joinListener) {
+        joinListener->report(cout, receiver.getLatency());
+        cout << "Multitopic ";
+        participant->get_simulated_multitopic_status().report(cout);
+        participant->get_simulated_multitopic_names().report(cout);
+        participant->report_simulated_multitopic_copies(cout);
+    }
+    cout << "Memory: " << fixed << setprecision(1) << residentBytes() / 1048576.0 << " MB resident";
+    if (readers > 1) {
+        cout << ", " << (residentAfter - residentBefore) / 1024.0 / (readers - 1)
+             << " KB per additional reader at creation (" << readers << " readers, "
+             << subscribers << " subscribers)";
+    }
+    cout << endl;
+
+    /* Keep the latency histogram, so that it can be merged with other runs. */
+    if (histogramFile) {
+        ofstream histogramOut(histogramFile);
+        receiver.saveLatency(histogramOut);
+        if (!histogramOut) {
+            cerr << "Error in writing " << histogramFile << endl;
         }
+    }
 
-        status = chatAdmin->return_loan(msgSeq, infoSeq);
-        checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
-        
-        /* Sleep for some amount of time, as not to consume too much CPU cycles. */
-#ifdef USE_NANOSLEEP
-        sleeptime.tv_sec = 0;
-        sleeptime.tv_nsec = 100000000;
-        nanosleep(&sleeptime, &remtime);
-#else
-        usleep(100000);
-#endif
+    /* Remove the additional DataReaders and Subscribers. */
+    for (ULong i = 0; i < fanOutReaders.size(); i++) {
+        status = fanOutReaders[i]->set_listener(NULL, STATUS_MASK_NONE);
+        checkStatus(status, "DDS::DataReader::set_listener (fan-out)");
+        Subscriber_ptr subscriber = ((i + 1) % subscribers == 0) ?
+            chatSubscriber.in() : fanOutSubscribers[(i + 1) % subscribers - 1];
+        status = subscriber->delete_datareader(fanOutReaders[i]);
+        checkStatus(status, "DDS::Subscriber::delete_datareader (fan-out)");
+        DDS::release(fanOutReaders[i]);
+        DDS::release(fanOutListeners[i]);
     }
+    for (ULong i = 0; i < fanOutSubscribers.size(); i++) {
+        status = participant->delete_subscriber(fanOutSubscribers[i]);
+        checkStatus(status, "DDS::DomainParticipant::delete_subscriber (fan-out)");
+        DDS::release(fanOutSubscribers[i]);
+    }
+    delete skew;
+    delete capture;
+    delete stats;
+
+    /* Remove the DataReaders */
+    status = chatSubscriber->delete_datareader(controlAdmin.in());
+    checkStatus(status, "DDS::Subscriber::delete_datareader (RunControl)");
 
-    /* Remove the DataReader */
     status = chatSubscriber->delete_datareader(chatAdmin.in());
     checkStatus(status, "DDS::Subscriber::delete_datareader");
+    DDS::release(readerStatus);
+    if (filter == FILTER_CFT) {
+        status = participant->delete_contentfilteredtopic(ownFilterTopic.in());
+        checkStatus(status, "DDS::DomainParticipant::delete_contentfilteredtopic");
+    }
+
+    if (join) {
+        status = joinAdmin->set_listener(NULL, STATUS_MASK_NONE);
+        checkStatus(status, "DDS::DataReader::set_listener (NamedMessage)");
+        status = chatSubscriber->delete_datareader(joinAdmin.in());
+        checkStatus(status, "DDS::Subscriber::delete_datareader (NamedMessage)");
+        DDS::release(joinListener);
+    }
 
     /* Remove the Subscriber. */
     status = participant->delete_subscriber(chatSubscriber.in());
     checkStatus(status, "DDS::DomainParticipant::delete_subscriber");
     
     /* Remove the Topics. */
-    status = participant->delete_simulated_multitopic(namedMessageTopic.in());
-    checkStatus(status, "DDS::ExtDomainParticipant::delete_simulated_multitopic");
+    if (join) {
+        status = participant->delete_simulated_multitopic(namedMessageTopic.in());
+        checkStatus(status, "DDS::ExtDomainParticipant::delete_simulated_multitopic");
+
+        status = participant->delete_topic(nameServiceTopic.in());
+        checkStatus(status, "DDS::DomainParticipant::delete_topic (nameServiceTopic)");
+    }
 
-    status = participant->delete_topic(nameServiceTopic.in());
-    checkStatus(status, "DDS::DomainParticipant::delete_topic (nameServiceTopic)");
+    status = participant->delete_topic(runControlTopic.in());
+    checkStatus(status, "DDS::DomainParticipant::delete_topic (runControlTopic)");
 
     status = participant->delete_topic(chatMessageTopic.in());
     checkStatus(status, "DDS::DomainParticipant::delete_topic (chatMessageTopic)");
@@ -394,11 +757,166 @@ void printReaderQos(DDS::DataReaderQos readerQos) {
   cout << endl;
 }
 
-void printCurrentTime(DDS::DomainParticipant &participant) {
-	Time_t currentTime;
-	ReturnCode_t status = participant.get_current_time(currentTime);
-	checkStatus(status, "DDS::DomainParticipant::get_current_time");
+/**
+ * Receive mode that periodically takes whatever has arrived in the meantime.
+ **/
+void pollingLoop(ChatReceiver &receiver) {
+#ifdef USE_NANOSLEEP
+    struct timespec                 sleeptime;
+    struct timespec                 remtime;
+#endif
+
+    while (!receiver.drained()) {
+        receiver.takeMessages();
 
-	double formattedTime = (double)currentTime.sec + (double)currentTime.nanosec * 1.0E-9;
-	cout << "Current time: " << fixed << setprecision(6) << formattedTime << endl;
+        /* Process the run announcements only after the messages that preceded them. */
+        receiver.takeAnnouncements();
+        receiver.tick();
+        
+        /* Sleep for some amount of time, as not to consume too much CPU cycles. */
+#ifdef USE_NANOSLEEP
+        sleeptime.tv_sec = 0;
+        sleeptime.tv_nsec = POLL_PERIOD;
+        nanosleep(&sleeptime, &remtime);
+#else
+        usleep(POLL_PERIOD / 1000);
+#endif
+    }
+}
+
+/**
+ * Receive mode that blocks in a WaitSet until new data has arrived.
+ **/
+void waitSetLoop(
+    ChatReceiver &receiver,
+    ChatMessageDataReader_ptr chatAdmin,
+    RunControlDataReader_ptr controlAdmin) {
+    ReadCondition_var               newMessages;
+    ReadCondition_var               newAnnouncements;
+    WaitSet_var                     boardWS;
+    ConditionSeq                    guardList;
+    Duration_t                      drainCheck = toDuration(POLL_PERIOD);
+    ReturnCode_t                    status;
+
+    /* Create ReadConditions that trigger on unread messages and announcements;
+       the last message of a leaving Chatter may land on a disposed instance. */
+    newMessages = chatAdmin->create_readcondition( 
+        NOT_READ_SAMPLE_STATE, 
+        ANY_VIEW_STATE, 
+        ANY_INSTANCE_STATE);
+    checkHandle(newMessages.in(), "DDS::DataReader::create_readcondition (newMessages)");
+    newAnnouncements = controlAdmin->create_readcondition( 
+        NOT_READ_SAMPLE_STATE, 
+        ANY_VIEW_STATE, 
+        ANY_INSTANCE_STATE);
+    checkHandle(newAnnouncements.in(), "DDS::DataReader::create_readcondition (newAnnouncements)");
+
+    /* Create a waitset and add the ReadConditions */
+    boardWS = new WaitSet();
+    status = boardWS->attach_condition(newMessages.in());
+    checkStatus(status, "DDS::WaitSet::attach_condition (newMessages)");
+    status = boardWS->attach_condition(newAnnouncements.in());
+    checkStatus(status, "DDS::WaitSet::attach_condition (newAnnouncements)");
+
+    /* Initialize and pre-allocate the GuardList used to obtain the triggered Conditions. */
+    guardList.length(2);
+
+    while (!receiver.drained()) {
+        /* Wait for data, but wake up now and then to notice drain timeouts. */
+        status = boardWS->wait(guardList, drainCheck);
+        receiver.tick();
+        if (status == RETCODE_TIMEOUT) {
+            /* Take whatever no condition reported before checking the drain again. */
+            receiver.takeMessages();
+            continue;
+        }
+        checkStatus(status, "DDS::WaitSet::wait");
+
+        /* The messages are always taken first, the announcements may concern them. */
+        bool messages = false;
+        bool announcements = false;
+        for (ULong i = 0; i < guardList.length(); i++) {
+            if (guardList[i].in() == newMessages.in()) {
+                messages = true;
+            } else if (guardList[i].in() == newAnnouncements.in()) {
+                announcements = true;
+            }
+        }
+        if (messages || announcements) {
+            receiver.takeMessages();
+        }
+        if (announcements) {
+            receiver.takeAnnouncements();
+        }
+    }
+
+    /* Remove the Conditions again. */
+    status = boardWS->detach_condition(newAnnouncements.in());
+    checkStatus(status, "DDS::WaitSet::detach_condition (newAnnouncements)");
+    status = boardWS->detach_condition(newMessages.in());
+    checkStatus(status, "DDS::WaitSet::detach_condition (newMessages)");
+    status = controlAdmin->delete_readcondition(newAnnouncements.in());
+    checkStatus(status, "DDS::DataReader::delete_readcondition (newAnnouncements)");
+    status = chatAdmin->delete_readcondition(newMessages.in());
+    checkStatus(status, "DDS::DataReader::delete_readcondition (newMessages)");
+}
+
+/**
+ * Receive mode in which the middleware calls on_data_available, while the
+ * main thread only checks now and then whether everything has drained.
+ **/
+void listenerLoop(
+    ChatReceiver &receiver,
+    ChatMessageDataReader_ptr chatAdmin,
+    RunControlDataReader_ptr controlAdmin,
+    StatusMonitor &monitor) {
+    ChatReceiverListener            *msgListener;
+    ChatReceiverListener            *controlListener;
+    ReturnCode_t                    status;
+
+    /* Allocate the DataReaderListener Implementations. */
+    msgListener = new ChatReceiverListener(receiver, false, monitor);
+    checkHandle(msgListener, "new ChatReceiverListener (messages)");
+    controlListener = new ChatReceiverListener(receiver, true, monitor);
+    checkHandle(controlListener, "new ChatReceiverListener (announcements)");
+
+    /* Attach the DataReaderListeners to the DataReaders, for the data_available event and the monitored statuses. */
+    status = chatAdmin->set_listener(msgListener, DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
+    checkStatus(status, "DDS::DataReader::set_listener (messages)");
+    status = controlAdmin->set_listener(controlListener, DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
+    checkStatus(status, "DDS::DataReader::set_listener (announcements)");
+
+    /* Data that arrived before the listeners were attached does not trigger them. */
+    receiver.takeMessages();
+    receiver.takeAnnouncements();
+
+    while (!receiver.drained()) {
+        usleep(POLL_PERIOD / 1000);
+        receiver.tick();
+    }
+
+    /* Detach and release the DataReaderListeners. */
+    status = controlAdmin->set_listener(NULL, STATUS_MASK_NONE);
+    checkStatus(status, "DDS::DataReader::set_listener (announcements)");
+    status = chatAdmin->set_listener(NULL, STATUS_MASK_NONE);
+    checkStatus(status, "DDS::DataReader::set_listener (messages)");
+    DDS::release(controlListener);
+    DDS::release(msgListener);
+}
+
+/**
+ * Receive mode that takes in a busy loop: lowest latency, but one core is
+ * fully used even when nothing arrives.
+ **/
+void spinLoop(ChatReceiver &receiver) {
+    for (;;) {
+        receiver.tick();
+        if (receiver.takeMessages() == 0) {
+            /* Only look at the announcements when there is nothing else to do. */
+            receiver.takeAnnouncements();
+            if (receiver.drained()) {
+                break;
+            }
+        }
+    }
 }
@@ -0,0 +1,140 @@
+/************************************************************************
+ * LOGICAL_NAME:    Replay.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the traffic that the Chatter
+ * replays.
+ * 
+ ***/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <ctype.h>
+#include <stdlib.h>
+
+#include "Replay.h"
+#include "CaptureLog.h"
+
+using namespace std;
+
+/**
+ * Orders the messages by time; messages at the same time keep their order.
+ **/
+static bool
+earlier(const ReplayMessage &a, const ReplayMessage &b)
+{
+    return a.time < b.time;
+}
+
+Replay::Replay(const char *fileName)
+{
+    if (!loadCapture(fileName) && !loadCsv(fileName)) {
+        cerr << "Error in reading replay " << fileName << endl;
+        exit(-1);
+    }
+    if (messages.empty()) {
+        cerr << "Nothing to replay in " << fileName << endl;
+        exit(-1);
+    }
+
+    /* A capture is in the order of taking, which may differ from writing. */
+    stable_sort(messages.begin(), messages.end(), earlier);
+    DDS::LongLong start = messages[0].time;
+    for (DDS::ULong i = 0; i < messages.size(); i++) {
+        messages[i].time -= start;
+    }
+}
+
+DDS::ULong Replay::userOf(DDS::Long userID)
+{
+    UserMap::iterator found = users.find(userID);
+
+    if (found != users.end()) {
+        return found->second;
+    }
+    users[userID] = userIDs.size();
+    userIDs.push_back(userID);
+    return userIDs.size() - 1;
+}
+
+bool Replay::loadCapture(const char *fileName)
+{
+    CaptureReader reader;
+    CaptureRecord record;
+
+    if (!reader.open(fileName)) {
+        return false;
+    }
+    while (!reader.done()) {
+        if (!reader.read(record)) {
+            cerr << "Error in reading capture " << fileName << endl;
+            exit(-1);
+        }
+        if (record.length > REPLAY_MAX_LENGTH) {
+            cerr << "Message of " << record.length << " bytes in capture " << fileName
+                 << ", at most " << REPLAY_MAX_LENGTH << " can be replayed" << endl;
+            exit(-1);
+        }
+        ReplayMessage message;
+        message.time = record.sourceTime;
+        message.user = userOf(record.userID);
+        message.length = record.length;
+        message.content.assign(record.payload, record.length < CAPTURE_PAYLOAD ? record.length : CAPTURE_PAYLOAD);
+        messages.push_back(message);
+    }
+    return true;
+}
+
+bool Replay::loadCsv(const char *fileName)
+{
+    ifstream in(fileName);
+    string line;
+
+    if (!in) {
+        return false;
+    }
+    while (getline(in, line)) {
+        istringstream fields(line);
+        ReplayMessage message;
+        DDS::Long userID;
+        char comma1;
+        char comma2;
+
+        if (line.empty() || !(isdigit(line[0]) || line[0] == '-')) {
+            continue;
+        }
+        if (!(fields >> message.time >> comma1 >> userID >> comma2 >> message.length) ||
+            comma1 != ',' || comma2 != ',') {
+            cerr << "Malformed replay line: " << line << endl;
+            return false;
+        }
+        /* The size is padded to when sending; a negative one wraps around and is caught here too. */
+        if (message.length > REPLAY_MAX_LENGTH) {
+            cerr << "Replay line with more than " << REPLAY_MAX_LENGTH << " bytes: " << line << endl;
+            return false;
+        }
+        message.user = userOf(userID);
+        messages.push_back(message);
+    }
+    return true;
+}
+
+const std::vector<ReplayMessage> &Replay::getMessages() const
+{
+    return messages;
+}
+
+DDS::ULong Replay::getUsers() const
+{
+    return userIDs.size();
+}
+
+DDS::Long Replay::getUserID(DDS::ULong user) const
+{
+    return userIDs[user];
+}
@@ -0,0 +1,71 @@
+/************************************************************************
+ * LOGICAL_NAME:    Replay.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the traffic that the Chatter replays,
+ * loaded from a capture or a CSV file.
+ * 
+ ***/
+
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <string>
+#include <vector>
+#include <tr1/unordered_map>
+
+#include "ccpp_dds_dcps.h"
+
+#define REPLAY_MAX_LENGTH (1 << 20)     /* bytes of content a message may have */
+
+/**
+ * One message to replay. The users are numbered in order of appearance,
+ * so that the replay can map them onto its own userIDs.
+ **/
+struct ReplayMessage {
+    DDS::LongLong                       time;           /* ns since the first message */
+    DDS::ULong                          user;
+    DDS::ULong                          length;         /* of the content to send */
+    std::string                         content;        /* what is known of it, padded when sent */
+};
+
+/**
+ * The messages of a traffic pattern, in order of their source timestamps.
+ * They are read from a capture of the MessageBoard, or from a CSV file
+ * with one "timestamp_ns,userID,size" line per message; lines that do not
+ * start with a number, like a header, are skipped. A file with a message
+ * longer than REPLAY_MAX_LENGTH is rejected.
+ **/
+class Replay {
+
+    typedef std::tr1::unordered_map<DDS::Long, DDS::ULong> UserMap;
+
+    std::vector<ReplayMessage>          messages;
+    std::vector<DDS::Long>              userIDs;        /* original userID per user */
+    UserMap                             users;          /* user per original userID */
+
+    /* Returns the number of the user with the given userID, adding it if new. */
+    DDS::ULong userOf(DDS::Long userID);
+
+    /* Load the messages, return false if the file is not of that kind. */
+    bool loadCapture(const char *fileName);
+    bool loadCsv(const char *fileName);
+
+public:
+    /* Constructor: load the file, exits on failure. */
+    Replay(const char *fileName);
+
+    /* Returns the messages, ordered by time. */
+    const std::vector<ReplayMessage> &getMessages() const;
+
+    /* Returns the number of users that wrote them. */
+    DDS::ULong getUsers() const;
+
+    /* Returns the original userID of a user. */
+    DDS::Long getUserID(DDS::ULong user) const;
+};
+
+#endif
@@ -0,0 +1,216 @@
+/************************************************************************
+ * LOGICAL_NAME:    RunControl.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the operations around the
+ * RunControl topic.
+ * 
+ ***/
+
+#include <iomanip>
+
+#include "RunControl.h"
+#include "CheckStatus.h"
+#include "Timing.h"
+
+/**
+ * Returns a hash of a textual publisher configuration (32-bit FNV-1a).
+ **/
+DDS::ULong hashConfiguration(const char *configuration)
+{
+    DDS::ULong hash = 2166136261UL;
+
+    for (const char *c = configuration; *c; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619UL;
+    }
+    return hash & 0xffffffffUL;
+}
+
+/**
+ * Registers the RunControl type and creates the Chat_RunControl topic.
+ **/
+DDS::Topic_ptr createRunControlTopic(DDS::DomainParticipant_ptr participant)
+{
+    Chat::RunControlTypeSupport_var     runControlTS;
+    DDS::TopicQos                       control_topic_qos;
+    DDS::Topic_ptr                      runControlTopic;
+    char                                *runControlTypeName;
+    DDS::ReturnCode_t                   status;
+
+    /* Register the required datatype for RunControl. */
+    runControlTS = new Chat::RunControlTypeSupport();
+    checkHandle(runControlTS.in(), "new RunControlTypeSupport");
+    runControlTypeName = runControlTS->get_type_name();
+    status = runControlTS->register_type(participant, runControlTypeName);
+    checkStatus(status, "Chat::RunControlTypeSupport::register_type");
+
+    /* Announcements must not get lost and must reach late joiners as well. */
+    status = participant->get_default_topic_qos(control_topic_qos);
+    checkStatus(status, "DDS::DomainParticipant::get_default_topic_qos");
+    control_topic_qos.reliability.kind = DDS::RELIABLE_RELIABILITY_QOS;
+    control_topic_qos.durability.kind = DDS::TRANSIENT_DURABILITY_QOS;
+
+    /* Create the RunControl Topic. */
+    runControlTopic = participant->create_topic(
+        "Chat_RunControl",
+        runControlTypeName,
+        control_topic_qos,
+        NULL,
+        DDS::STATUS_MASK_NONE);
+    checkHandle(runControlTopic, "DDS::DomainParticipant::create_topic (RunControl)");
+
+    DDS::string_free(runControlTypeName);
+    return runControlTopic;
+}
+
+RunTracker::RunTracker(DDS::LongLong drainTimeout, DDS::LongLong since)
+    : drainTimeout(drainTimeout), since(since), stale(0) { }
+
+RunTracker::Run & RunTracker::lookup(DDS::Long userID)
+{
+    std::map<DDS::Long, Run>::iterator it = runs.find(userID);
+
+    if (it == runs.end()) {
+        Run run;
+        run.announced = false;
+        run.ended = false;
+        run.configHash = 0;
+        run.sent = 0;
+        run.received = 0;
+        run.firstReceived = 0;
+        run.lastReceived = 0;
+        run.lastActivity = 0;
+        it = runs.insert(std::make_pair(userID, run)).first;
+    }
+    return it->second;
+}
+
+void RunTracker::control(const Chat::RunControl &announcement, const DDS::SampleInfo &info, DDS::LongLong now)
+{
+    if (announcement.kind == Chat::RUN_START) {
+        /* A run that started before us, or whose Chatter already left, can
+           never be accounted for completely. */
+        if (info.instance_state != DDS::ALIVE_INSTANCE_STATE || toNanos(info.source_timestamp) < since) {
+            stale++;
+            return;
+        }
+    } else {
+        /* The end of a run is only meaningful when its start was accepted;
+           the Chatter may have disposed the announcement right after it. */
+        std::map<DDS::Long, Run>::iterator it = runs.find(announcement.userID);
+
+        if (it == runs.end() || !it->second.announced) {
+            stale++;
+            return;
+        }
+    }
+
+    Run &run = lookup(announcement.userID);
+
+    run.announced = true;
+    run.configHash = announcement.configHash;
+    run.sent = announcement.sentCount;
+    run.lastActivity = now;
+    if (announcement.kind == Chat::RUN_START) {
+        /* A new run for a known instance starts counting from scratch. */
+        if (run.ended) {
+            run.ended = false;
+            run.received = 0;
+            run.firstReceived = 0;
+        }
+    } else if (announcement.kind == Chat::RUN_END) {
+        run.ended = true;
+    }
+}
+
+void RunTracker::received(DDS::Long userID, DDS::LongLong now)
+{
+    Run &run = lookup(userID);
+
+    if (run.received == 0) {
+        run.firstReceived = now;
+    }
+    run.received++;
+    run.lastReceived = now;
+    run.lastActivity = now;
+}
+
+bool RunTracker::drained(DDS::LongLong now) const
+{
+    bool anyAnnounced = false;
+
+    for (std::map<DDS::Long, Run>::const_iterator it = runs.begin(); it != runs.end(); it++) {
+        const Run &run = it->second;
+
+        /* Instances that never announced a run cannot block termination. */
+        if (!run.announced) {
+            continue;
+        }
+        anyAnnounced = true;
+        if (!run.ended) {
+            return false;
+        }
+        /* Wait for in-flight messages, unless they are evidently lost. */
+        if (run.received < run.sent && now - run.lastActivity < drainTimeout) {
+            return false;
+        }
+    }
+    return anyAnnounced;
+}
+
+void RunTracker::report(std::ostream &out) const
+{
+    DDS::LongLong totalSent = 0;
+    DDS::LongLong totalReceived = 0;
+    DDS::ULong firstHash = 0;
+    bool firstRun = true;
+    bool mixedConfigs = false;
+
+    out << "Run summary:" << endl;
+    for (std::map<DDS::Long, Run>::const_iterator it = runs.begin(); it != runs.end(); it++) {
+        const Run &run = it->second;
+
+        out << "  userID " << it->first << ": ";
+        if (!run.announced) {
+            out << "unannounced, received " << run.received << endl;
+            continue;
+        }
+        if (firstRun) {
+            firstHash = run.configHash;
+            firstRun = false;
+        } else if (run.configHash != firstHash) {
+            mixedConfigs = true;
+        }
+        totalSent += run.sent;
+        totalReceived += run.received;
+
+        DDS::LongLong lost = run.sent > run.received ? run.sent - run.received : 0;
+        out << "config " << hex << setw(8) << setfill('0') << run.configHash << dec << setfill(' ')
+            << (run.ended ? "" : " (not ended)")
+            << ", sent " << run.sent
+            << ", received " << run.received
+            << ", lost " << lost;
+        if (run.sent > 0) {
+            out << " (" << fixed << setprecision(2) << 100.0 * lost / run.sent << "%)";
+        }
+        if (run.received > 1 && run.lastReceived > run.firstReceived) {
+            out << ", " << fixed << setprecision(1)
+                << (run.received - 1) / nanosToSeconds(run.lastReceived - run.firstReceived)
+                << " msg/s";
+        }
+        out << endl;
+    }
+    DDS::LongLong totalLost = totalSent > totalReceived ? totalSent - totalReceived : 0;
+    out << "  total: sent " << totalSent << ", received " << totalReceived
+        << ", lost " << totalLost << endl;
+    if (mixedConfigs) {
+        out << "  warning: runs used different configurations" << endl;
+    }
+    if (stale > 0) {
+        out << "  " << stale << " announcements of earlier or departed runs ignored" << endl;
+    }
+}
@@ -0,0 +1,80 @@
+/************************************************************************
+ * LOGICAL_NAME:    RunControl.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the operations around the RunControl
+ * topic, on which every Chatter announces the start and the end of its run.
+ * 
+ ***/
+
+#ifndef __RUNCONTROL_H__
+#define __RUNCONTROL_H__
+
+#include <map>
+#include <iostream>
+
+#include "ccpp_dds_dcps.h"
+#include "ccpp_Chat.h"
+
+/**
+ * Returns a hash of a textual publisher configuration, so that receivers can
+ * tell runs with different settings apart.
+ **/
+DDS::ULong hashConfiguration(const char *configuration);
+
+/**
+ * Registers the RunControl type and creates the (reliable, transient)
+ * Chat_RunControl topic.
+ **/
+DDS::Topic_ptr createRunControlTopic(DDS::DomainParticipant_ptr participant);
+
+/**
+ * Keeps track of the announced runs and of the messages received for them,
+ * to compute the exact loss per instance and to detect when all in-flight
+ * messages have been drained. Only runs that start while the tracker exists
+ * count: the announcements of earlier runs that the durability service
+ * still delivers as history are ignored, as are those of Chatters that
+ * already left.
+ **/
+class RunTracker {
+
+    struct Run {
+        bool                            announced;
+        bool                            ended;
+        DDS::ULong                      configHash;
+        DDS::LongLong                   sent;
+        DDS::LongLong                   received;
+        DDS::LongLong                   firstReceived;
+        DDS::LongLong                   lastReceived;
+        DDS::LongLong                   lastActivity;
+    };
+
+    std::map<DDS::Long, Run>            runs;
+    DDS::LongLong                       drainTimeout;
+    DDS::LongLong                       since;          /* runs started before are history */
+    DDS::ULong                          stale;          /* announcements ignored */
+
+    Run & lookup(DDS::Long userID);
+
+public:
+    /* Constructor: runs that ended are considered drained after drainTimeout ns
+       without traffic; runs started before since (ns) are ignored. */
+    RunTracker(DDS::LongLong drainTimeout, DDS::LongLong since);
+
+    /* Process a RunControl announcement, with the SampleInfo it came with. */
+    void control(const Chat::RunControl &announcement, const DDS::SampleInfo &info, DDS::LongLong now);
+
+    /* Account for a ChatMessage received for userID. */
+    void received(DDS::Long userID, DDS::LongLong now);
+
+    /* Returns whether all announced runs have ended and all their messages arrived (or timed out). */
+    bool drained(DDS::LongLong now) const;
+
+    /* Print the sent/received/lost counts and the throughput per instance. */
+    void report(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,135 @@
+/************************************************************************
+ * LOGICAL_NAME:    SequenceTracker.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the detection of lost,
+ * duplicate and reordered messages.
+ * 
+ ***/
+
+#include "SequenceTracker.h"
+
+using namespace std;
+
+SequenceTracker::SequenceTracker() : lastState(NULL), disposed(0), unregistered(0) { }
+
+void SequenceTracker::received(DDS::Long userID, DDS::InstanceHandle_t publication, DDS::Long index)
+{
+    WriterState *state;
+
+    /* Find the state of this writer; pointers stay valid when the map grows. */
+    if (lastState && lastKey.userID == userID && lastKey.publication == publication) {
+        state = lastState;
+    } else {
+        WriterKey key;
+        key.userID = userID;
+        key.publication = publication;
+
+        WriterMap::iterator it = writers.find(key);
+        if (it == writers.end()) {
+            /* Start counting at the first message seen: earlier ones may predate us. */
+            WriterState initial;
+            initial.highest = index;
+            initial.window = 1;
+            initial.received = 1;
+            initial.lost = 0;
+            initial.duplicates = 0;
+            initial.reordered = 0;
+            initial.late = 0;
+            lastState = &writers.insert(make_pair(key, initial)).first->second;
+            lastKey = key;
+            return;
+        }
+        state = &it->second;
+        lastState = state;
+        lastKey = key;
+    }
+
+    if (index > state->highest) {
+        /* In order (possibly after a gap): slide the window. */
+        DDS::ULongLong gap = (DDS::ULongLong)index - state->highest;
+        state->lost += gap - 1;
+        state->window = gap >= SEQUENCE_WINDOW ? 1 : (state->window << gap) | 1;
+        state->highest = index;
+        state->received++;
+    } else {
+        DDS::ULongLong distance = (DDS::ULongLong)state->highest - index;
+        if (distance >= SEQUENCE_WINDOW) {
+            /* Too old to know whether it fills a gap or repeats a message:
+               kept out of received, so it cannot count twice with lost. */
+            state->late++;
+        } else if (state->window & (1ULL << distance)) {
+            state->duplicates++;
+        } else {
+            /* Fills a gap that was counted as lost before. */
+            state->window |= 1ULL << distance;
+            state->lost--;
+            state->reordered++;
+            state->received++;
+        }
+    }
+}
+
+void SequenceTracker::notification(DDS::InstanceStateKind instanceState)
+{
+    if (instanceState == DDS::NOT_ALIVE_DISPOSED_INSTANCE_STATE) {
+        disposed++;
+    } else if (instanceState == DDS::NOT_ALIVE_NO_WRITERS_INSTANCE_STATE) {
+        unregistered++;
+    }
+}
+
+void SequenceTracker::getTotals(
+    DDS::ULongLong &lost,
+    DDS::ULongLong &duplicates,
+    DDS::ULongLong &reordered) const
+{
+    lost = 0;
+    duplicates = 0;
+    reordered = 0;
+    for (WriterMap::const_iterator it = writers.begin(); it != writers.end(); it++) {
+        lost += it->second.lost;
+        duplicates += it->second.duplicates;
+        reordered += it->second.reordered;
+    }
+}
+
+void SequenceTracker::report(std::ostream &out) const
+{
+    DDS::ULongLong received = 0;
+    DDS::ULongLong lost = 0;
+    DDS::ULongLong duplicates = 0;
+    DDS::ULongLong reordered = 0;
+    DDS::ULongLong late = 0;
+
+    out << "Sequence summary:" << endl;
+    for (WriterMap::const_iterator it = writers.begin(); it != writers.end(); it++) {
+        const WriterState &state = it->second;
+
+        out << "  userID " << it->first.userID
+            << " (publication " << it->first.publication << ")"
+            << ": received " << state.received
+            << ", lost " << state.lost
+            << ", duplicates " << state.duplicates
+            << ", reordered " << state.reordered;
+        if (state.late) {
+            out << ", late " << state.late;
+        }
+        out << endl;
+        received += state.received;
+        lost += state.lost;
+        duplicates += state.duplicates;
+        reordered += state.reordered;
+        late += state.late;
+    }
+    out << "  total: received " << received
+        << ", lost " << lost
+        << ", duplicates " << duplicates
+        << ", reordered " << reordered
+        << ", late " << late << endl;
+    out << "  invalid-data samples: disposed " << disposed
+        << ", unregistered " << unregistered << endl;
+}
@@ -0,0 +1,82 @@
+/************************************************************************
+ * LOGICAL_NAME:    SequenceTracker.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the detection of lost, duplicate and
+ * reordered messages, per writer of a ChatMessage instance.
+ * 
+ ***/
+
+#ifndef __SEQUENCETRACKER_H__
+#define __SEQUENCETRACKER_H__
+
+#include <iostream>
+#include <tr1/unordered_map>
+
+#include "ccpp_dds_dcps.h"
+
+/* Number of indices below the highest one for which arrival is remembered. */
+#define SEQUENCE_WINDOW 64
+
+class SequenceTracker {
+
+    /* A writer of an instance is identified by the userID and the publication handle. */
+    struct WriterKey {
+        DDS::Long                       userID;
+        DDS::InstanceHandle_t           publication;
+
+        bool operator==(const WriterKey &other) const {
+            return userID == other.userID && publication == other.publication;
+        }
+    };
+
+    struct WriterKeyHash {
+        size_t operator()(const WriterKey &key) const {
+            DDS::ULongLong h = (DDS::ULongLong)key.publication * 0x9e3779b97f4a7c15ULL;
+            return (size_t)(h ^ (h >> 32) ^ (DDS::ULong)key.userID);
+        }
+    };
+
+    struct WriterState {
+        DDS::Long                       highest;        /* highest index seen */
+        DDS::ULongLong                  window;         /* bit i: index highest - i arrived */
+        DDS::ULongLong                  received;       /* in order or filling a gap */
+        DDS::ULongLong                  lost;           /* gaps not filled (yet) */
+        DDS::ULongLong                  duplicates;
+        DDS::ULongLong                  reordered;      /* arrived after a higher index */
+        DDS::ULongLong                  late;           /* too old for the window to tell */
+    };
+
+    typedef std::tr1::unordered_map<WriterKey, WriterState, WriterKeyHash> WriterMap;
+
+    WriterMap                           writers;
+
+    /* Consecutive samples mostly come from the same writer. */
+    WriterKey                           lastKey;
+    WriterState                         *lastState;
+
+    /* Invalid-data samples: instance state changes without a message. */
+    DDS::ULongLong                      disposed;
+    DDS::ULongLong                      unregistered;
+
+public:
+    /* Constructor */
+    SequenceTracker();
+
+    /* Account for a valid message with the given index. */
+    void received(DDS::Long userID, DDS::InstanceHandle_t publication, DDS::Long index);
+
+    /* Account for an invalid-data sample (dispose or unregister notification). */
+    void notification(DDS::InstanceStateKind instanceState);
+
+    /* Returns the lost, duplicate and reordered counts of all writers together. */
+    void getTotals(DDS::ULongLong &lost, DDS::ULongLong &duplicates, DDS::ULongLong &reordered) const;
+
+    /* Print the lost, duplicate and reordered counts per writer and in total. */
+    void report(std::ostream &out) const;
+};
+
+#endif
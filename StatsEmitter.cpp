@@ -0,0 +1,176 @@
+/************************************************************************
+ * LOGICAL_NAME:    StatsEmitter.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the machine-readable
+ * statistics of the executables.
+ * 
+ ***/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "StatsEmitter.h"
+#include "Timing.h"
+
+using namespace std;
+
+StatsEmitter::StatsEmitter(const char *target, const char *program)
+    : program(program), firstField(true)
+{
+    if (strncmp(target, "fd:", 3) == 0) {
+        char *end;
+        long number = strtol(target + 3, &end, 10);
+
+        /* Only a whole number naming an open descriptor, not the 0 atoi makes of garbage. */
+        if (end == target + 3 || *end != '\0' || number < 0 || number > INT_MAX ||
+            fcntl((int)number, F_GETFD) < 0) {
+            cerr << "Error in statistics target " << target << ": not an open file descriptor" << endl;
+            exit(-1);
+        }
+        fd = (int)number;
+        ownFd = false;
+    } else {
+        fd = open(target, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        ownFd = true;
+    }
+    if (fd < 0) {
+        cerr << "Error in opening statistics target " << target << ": " << strerror(errno) << endl;
+        exit(-1);
+    }
+    startTime = currentTimeNanos();
+}
+
+StatsEmitter::~StatsEmitter()
+{
+    if (ownFd) {
+        close(fd);
+    }
+}
+
+void StatsEmitter::name(const char *fieldName)
+{
+    if (!firstField) {
+        record << ',';
+    }
+    firstField = false;
+    quoted(fieldName);
+    record << ':';
+}
+
+void StatsEmitter::quoted(const char *value)
+{
+    record << '"';
+    for (const char *c = value; *c; c++) {
+        switch (*c) {
+        case '"':   record << "\\\""; break;
+        case '\\':  record << "\\\\"; break;
+        case '\n':  record << "\\n"; break;
+        case '\t':  record << "\\t"; break;
+        default:
+            if ((unsigned char)*c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+                record << escaped;
+            } else {
+                record << *c;
+            }
+        }
+    }
+    record << '"';
+}
+
+void StatsEmitter::begin(const char *type)
+{
+    DDS::LongLong now = currentTimeNanos();
+
+    record.str("");
+    record << '{';
+    firstField = true;
+    text("program", program);
+    text("type", type);
+    number("time", nanosToSeconds(now));
+    number("elapsed_s", nanosToSeconds(now - startTime));
+}
+
+void StatsEmitter::integer(const char *fieldName, DDS::LongLong value)
+{
+    name(fieldName);
+    record << value;
+}
+
+void StatsEmitter::number(const char *fieldName, double value)
+{
+    name(fieldName);
+    record << fixed << setprecision(6) << value;
+}
+
+void StatsEmitter::text(const char *fieldName, const char *value)
+{
+    name(fieldName);
+    quoted(value);
+}
+
+void StatsEmitter::histogram(const char *fieldName, const Histogram &values, double scale)
+{
+    DDS::ULongLong count = values.getCount();
+
+    name(fieldName);
+    record << "{\"count\":" << count;
+    if (count > 0) {
+        record << fixed << setprecision(3)
+               << ",\"min\":" << values.getMin() / scale
+               << ",\"mean\":" << values.getMean() / scale
+               << ",\"p50\":" << values.getPercentile(50.0) / scale
+               << ",\"p90\":" << values.getPercentile(90.0) / scale
+               << ",\"p99\":" << values.getPercentile(99.0) / scale
+               << ",\"p99_9\":" << values.getPercentile(99.9) / scale
+               << ",\"max\":" << values.getMax() / scale;
+    }
+    record << '}';
+}
+
+void StatsEmitter::statuses(const StatusMonitor &monitor)
+{
+    integer("status_events", monitor.getEvents());
+    integer("samples_lost", monitor.getSamplesLost());
+    integer("samples_rejected", monitor.getSamplesRejected());
+    integer("incompatible_qos", monitor.getIncompatibleQos());
+    integer("deadlines_missed", monitor.getDeadlinesMissed());
+    integer("liveliness_lost", monitor.getLivelinessLosses());
+}
+
+void StatsEmitter::end()
+{
+    integer("rss_bytes", residentBytes());
+    number("cpu_s", nanosToSeconds(processCpuNanos()));
+    record << '}' << '\n';
+
+    /* One write per line, so a reader of a pipe gets whole records. */
+    string line = record.str();
+    const char *data = line.data();
+    size_t left = line.size();
+    while (left > 0) {
+        ssize_t written = write(fd, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "Error in writing statistics: " << strerror(errno) << endl;
+            return;
+        }
+        data += written;
+        left -= written;
+    }
+}
@@ -0,0 +1,70 @@
+/************************************************************************
+ * LOGICAL_NAME:    StatsEmitter.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the machine-readable statistics of
+ * the executables, written as JSON lines.
+ * 
+ ***/
+
+#ifndef __STATSEMITTER_H__
+#define __STATSEMITTER_H__
+
+#include <sstream>
+
+#include "ccpp_dds_dcps.h"
+#include "Histogram.h"
+#include "StatusMonitor.h"
+
+/**
+ * Writes one JSON object per line: a record is started with its type, e.g.
+ * "interval" or "summary", gets any number of fields and is written as a
+ * whole when it ends. Every record carries the program, the type, the time
+ * and, when it ends, the resident memory and CPU time of the process. The
+ * target is a file, which is appended to, or "fd:N" for a file descriptor
+ * that is already open, such as a pipe. Used by one thread at a time.
+ **/
+class StatsEmitter {
+
+    const char                          *program;
+    int                                 fd;
+    bool                                ownFd;
+    DDS::LongLong                       startTime;
+    std::ostringstream                  record;
+    bool                                firstField;
+
+    /* Start a field: the separator and the quoted name. */
+    void name(const char *fieldName);
+
+    /* Write a string as a quoted and escaped JSON string. */
+    void quoted(const char *value);
+
+public:
+    /* Constructor: open the target, exits on failure. */
+    StatsEmitter(const char *target, const char *program);
+
+    /* Destructor: close the target if it was opened here. */
+    ~StatsEmitter();
+
+    /* Start a record of the given type. */
+    void begin(const char *type);
+
+    /* Add a field to the record. */
+    void integer(const char *fieldName, DDS::LongLong value);
+    void number(const char *fieldName, double value);
+    void text(const char *fieldName, const char *value);
+
+    /* Add the count, mean and percentiles of a histogram, divided by scale. */
+    void histogram(const char *fieldName, const Histogram &values, double scale);
+
+    /* Add the events of the monitor, in total and per kind. */
+    void statuses(const StatusMonitor &monitor);
+
+    /* End the record and write it as one line. */
+    void end();
+};
+
+#endif
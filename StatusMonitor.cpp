@@ -0,0 +1,273 @@
+/************************************************************************
+ * LOGICAL_NAME:    StatusMonitor.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the monitoring of the
+ * communication statuses of the DataReaders and DataWriters.
+ * 
+ ***/
+
+#include "StatusMonitor.h"
+#include "Atomic.h"
+
+using namespace std;
+
+/**
+ * Returns the name of a QosPolicy, as used in the status reports.
+ **/
+static const char *
+policyName(DDS::QosPolicyId_t id)
+{
+    switch (id) {
+    case DDS::USERDATA_QOS_POLICY_ID:           return "USER_DATA";
+    case DDS::DURABILITY_QOS_POLICY_ID:         return "DURABILITY";
+    case DDS::PRESENTATION_QOS_POLICY_ID:       return "PRESENTATION";
+    case DDS::DEADLINE_QOS_POLICY_ID:           return "DEADLINE";
+    case DDS::LATENCYBUDGET_QOS_POLICY_ID:      return "LATENCY_BUDGET";
+    case DDS::OWNERSHIP_QOS_POLICY_ID:          return "OWNERSHIP";
+    case DDS::OWNERSHIPSTRENGTH_QOS_POLICY_ID:  return "OWNERSHIP_STRENGTH";
+    case DDS::LIVELINESS_QOS_POLICY_ID:         return "LIVELINESS";
+    case DDS::TIMEBASEDFILTER_QOS_POLICY_ID:    return "TIME_BASED_FILTER";
+    case DDS::PARTITION_QOS_POLICY_ID:          return "PARTITION";
+    case DDS::RELIABILITY_QOS_POLICY_ID:        return "RELIABILITY";
+    case DDS::DESTINATIONORDER_QOS_POLICY_ID:   return "DESTINATION_ORDER";
+    case DDS::HISTORY_QOS_POLICY_ID:            return "HISTORY";
+    case DDS::RESOURCELIMITS_QOS_POLICY_ID:     return "RESOURCE_LIMITS";
+    case DDS::LIFESPAN_QOS_POLICY_ID:           return "LIFESPAN";
+    default:                                    return "other";
+    }
+}
+
+static const char *rejectedNames[REJECTED_KINDS] = {
+    "not rejected", "instances limit", "samples limit", "samples per instance limit"
+};
+
+StatusMonitor::StatusMonitor()
+    : samplesLost(0), requestedIncompatible(0), offeredIncompatible(0),
+      requestedDeadlinesMissed(0), offeredDeadlinesMissed(0), livelinessLosses(0),
+      lastRejectReason(DDS::NOT_REJECTED),
+      lastRequestedPolicy(DDS::INVALID_QOS_POLICY_ID),
+      lastOfferedPolicy(DDS::INVALID_QOS_POLICY_ID),
+      reportedEvents(0)
+{
+    for (int i = 0; i < REJECTED_KINDS; i++) {
+        samplesRejected[i] = 0;
+    }
+    pthread_mutex_init(&lock, NULL);
+}
+
+StatusMonitor::~StatusMonitor()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void StatusMonitor::sampleLost(const DDS::SampleLostStatus &status)
+{
+    __sync_fetch_and_add(&samplesLost, (DDS::ULongLong)status.total_count_change);
+}
+
+void StatusMonitor::sampleRejected(const DDS::SampleRejectedStatus &status)
+{
+    int kind = status.last_reason < REJECTED_KINDS ? status.last_reason : DDS::NOT_REJECTED;
+
+    /* All changes are attributed to the last reason, the status tells no more. */
+    __sync_fetch_and_add(&samplesRejected[kind], (DDS::ULongLong)status.total_count_change);
+    pthread_mutex_lock(&lock);
+    lastRejectReason = status.last_reason;
+    pthread_mutex_unlock(&lock);
+}
+
+void StatusMonitor::requestedIncompatibleQos(const DDS::RequestedIncompatibleQosStatus &status)
+{
+    __sync_fetch_and_add(&requestedIncompatible, (DDS::ULongLong)status.total_count_change);
+    pthread_mutex_lock(&lock);
+    lastRequestedPolicy = status.last_policy_id;
+    pthread_mutex_unlock(&lock);
+}
+
+void StatusMonitor::offeredIncompatibleQos(const DDS::OfferedIncompatibleQosStatus &status)
+{
+    __sync_fetch_and_add(&offeredIncompatible, (DDS::ULongLong)status.total_count_change);
+    pthread_mutex_lock(&lock);
+    lastOfferedPolicy = status.last_policy_id;
+    pthread_mutex_unlock(&lock);
+}
+
+void StatusMonitor::requestedDeadlineMissed(const DDS::RequestedDeadlineMissedStatus &status)
+{
+    __sync_fetch_and_add(&requestedDeadlinesMissed, (DDS::ULongLong)status.total_count_change);
+}
+
+void StatusMonitor::offeredDeadlineMissed(const DDS::OfferedDeadlineMissedStatus &status)
+{
+    __sync_fetch_and_add(&offeredDeadlinesMissed, (DDS::ULongLong)status.total_count_change);
+}
+
+void StatusMonitor::livelinessLost(const DDS::LivelinessLostStatus &status)
+{
+    __sync_fetch_and_add(&livelinessLosses, (DDS::ULongLong)status.total_count_change);
+}
+
+DDS::ULongLong StatusMonitor::getEvents() const
+{
+    return getSamplesLost() + getSamplesRejected() + getIncompatibleQos() +
+        getDeadlinesMissed() + getLivelinessLosses();
+}
+
+DDS::ULongLong StatusMonitor::getSamplesLost() const
+{
+    return atomicRead(samplesLost);
+}
+
+DDS::ULongLong StatusMonitor::getSamplesRejected() const
+{
+    DDS::ULongLong rejected = 0;
+
+    for (int i = 0; i < REJECTED_KINDS; i++) {
+        rejected += atomicRead(samplesRejected[i]);
+    }
+    return rejected;
+}
+
+DDS::ULongLong StatusMonitor::getIncompatibleQos() const
+{
+    return atomicRead(requestedIncompatible) + atomicRead(offeredIncompatible);
+}
+
+DDS::ULongLong StatusMonitor::getDeadlinesMissed() const
+{
+    return atomicRead(requestedDeadlinesMissed) + atomicRead(offeredDeadlinesMissed);
+}
+
+DDS::ULongLong StatusMonitor::getLivelinessLosses() const
+{
+    return atomicRead(livelinessLosses);
+}
+
+void StatusMonitor::report(std::ostream &out)
+{
+    DDS::ULongLong rejectedKinds[REJECTED_KINDS];
+    DDS::ULongLong rejected = 0;
+    DDS::ULongLong lost = atomicRead(samplesLost);
+    DDS::ULongLong requested = atomicRead(requestedIncompatible);
+    DDS::ULongLong offered = atomicRead(offeredIncompatible);
+    DDS::ULongLong requestedDeadlines = atomicRead(requestedDeadlinesMissed);
+    DDS::ULongLong offeredDeadlines = atomicRead(offeredDeadlinesMissed);
+    DDS::ULongLong liveliness = atomicRead(livelinessLosses);
+    DDS::SampleRejectedStatusKind rejectReason;
+    DDS::QosPolicyId_t requestedPolicy;
+    DDS::QosPolicyId_t offeredPolicy;
+
+    /* Every counter is read once, so the line adds up to the events it reports. */
+    for (int i = 0; i < REJECTED_KINDS; i++) {
+        rejectedKinds[i] = atomicRead(samplesRejected[i]);
+        rejected += rejectedKinds[i];
+    }
+    DDS::ULongLong events = lost + rejected + requested + offered +
+        requestedDeadlines + offeredDeadlines + liveliness;
+
+    pthread_mutex_lock(&lock);
+    rejectReason = lastRejectReason;
+    requestedPolicy = lastRequestedPolicy;
+    offeredPolicy = lastOfferedPolicy;
+    pthread_mutex_unlock(&lock);
+
+    out << "Status: " << lost << " samples lost, " << rejected << " rejected";
+    if (rejected > 0) {
+        out << " (";
+        for (int i = 0; i < REJECTED_KINDS; i++) {
+            if (rejectedKinds[i] > 0) {
+                out << rejectedNames[i] << " " << rejectedKinds[i] << ", ";
+            }
+        }
+        out << "last: " << rejectedNames[rejectReason < REJECTED_KINDS ? rejectReason : 0] << ")";
+    }
+    out << ", incompatible QoS " << requested << " requested";
+    if (requested > 0) {
+        out << " (last " << policyName(requestedPolicy) << ")";
+    }
+    out << " / " << offered << " offered";
+    if (offered > 0) {
+        out << " (last " << policyName(offeredPolicy) << ")";
+    }
+    out << ", deadlines missed " << requestedDeadlines << " requested / "
+        << offeredDeadlines << " offered, liveliness lost " << liveliness
+        << "; " << events - reportedEvents << " new events" << endl;
+
+    reportedEvents = events;
+}
+
+StatusReaderListener::StatusReaderListener(StatusMonitor &monitor) : monitor(monitor) { }
+
+void StatusReaderListener::on_requested_deadline_missed (
+    DDS::DataReader_ptr reader,
+    const DDS::RequestedDeadlineMissedStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.requestedDeadlineMissed(status);
+}
+
+void StatusReaderListener::on_requested_incompatible_qos (
+    DDS::DataReader_ptr reader,
+    const DDS::RequestedIncompatibleQosStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.requestedIncompatibleQos(status);
+}
+
+void StatusReaderListener::on_sample_rejected (
+    DDS::DataReader_ptr reader,
+    const DDS::SampleRejectedStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.sampleRejected(status);
+}
+
+void StatusReaderListener::on_liveliness_changed (
+    DDS::DataReader_ptr reader,
+    const DDS::LivelinessChangedStatus & status
+) THROW_ORB_EXCEPTIONS { }
+
+void StatusReaderListener::on_data_available (
+    DDS::DataReader_ptr reader
+) THROW_ORB_EXCEPTIONS { }
+
+void StatusReaderListener::on_subscription_matched (
+    DDS::DataReader_ptr reader,
+    const DDS::SubscriptionMatchedStatus & status
+) THROW_ORB_EXCEPTIONS { }
+
+void StatusReaderListener::on_sample_lost (
+    DDS::DataReader_ptr reader,
+    const DDS::SampleLostStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.sampleLost(status);
+}
+
+StatusWriterListener::StatusWriterListener(StatusMonitor &monitor) : monitor(monitor) { }
+
+void StatusWriterListener::on_offered_deadline_missed (
+    DDS::DataWriter_ptr writer,
+    const DDS::OfferedDeadlineMissedStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.offeredDeadlineMissed(status);
+}
+
+void StatusWriterListener::on_offered_incompatible_qos (
+    DDS::DataWriter_ptr writer,
+    const DDS::OfferedIncompatibleQosStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.offeredIncompatibleQos(status);
+}
+
+void StatusWriterListener::on_liveliness_lost (
+    DDS::DataWriter_ptr writer,
+    const DDS::LivelinessLostStatus & status
+) THROW_ORB_EXCEPTIONS {
+    monitor.livelinessLost(status);
+}
+
+void StatusWriterListener::on_publication_matched (
+    DDS::DataWriter_ptr writer,
+    const DDS::PublicationMatchedStatus & status
+) THROW_ORB_EXCEPTIONS { }
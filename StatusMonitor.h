@@ -0,0 +1,172 @@
+/************************************************************************
+ * LOGICAL_NAME:    StatusMonitor.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the monitoring of the communication
+ * statuses of the DataReaders and DataWriters.
+ * 
+ ***/
+
+#ifndef __STATUSMONITOR_H__
+#define __STATUSMONITOR_H__
+
+#include <iostream>
+#include <pthread.h>
+
+#include "ccpp_dds_dcps.h"
+#include "orb_abstraction.h"
+
+/**
+ * The statuses the listeners below are attached for. A DataReaderListener
+ * that also takes the data adds DATA_AVAILABLE_STATUS.
+ **/
+#define MONITORED_READER_STATUS (DDS::SAMPLE_LOST_STATUS | DDS::SAMPLE_REJECTED_STATUS | \
+    DDS::REQUESTED_INCOMPATIBLE_QOS_STATUS | DDS::REQUESTED_DEADLINE_MISSED_STATUS)
+#define MONITORED_WRITER_STATUS (DDS::OFFERED_INCOMPATIBLE_QOS_STATUS | \
+    DDS::OFFERED_DEADLINE_MISSED_STATUS | DDS::LIVELINESS_LOST_STATUS)
+
+/* Number of SampleRejectedStatusKind values. */
+#define REJECTED_KINDS 4
+
+/**
+ * Counts the events that mean data did not arrive or could not be kept:
+ * lost and rejected samples, incompatible QoS, missed deadlines and lost
+ * liveliness. The listeners of any number of entities can count into one
+ * monitor, from any thread. Next to the counts it keeps the last reason a
+ * sample was rejected and the last policy that was incompatible.
+ **/
+class StatusMonitor {
+
+    DDS::ULongLong                      samplesLost;
+    DDS::ULongLong                      samplesRejected[REJECTED_KINDS];
+    DDS::ULongLong                      requestedIncompatible;
+    DDS::ULongLong                      offeredIncompatible;
+    DDS::ULongLong                      requestedDeadlinesMissed;
+    DDS::ULongLong                      offeredDeadlinesMissed;
+    DDS::ULongLong                      livelinessLosses;
+    DDS::SampleRejectedStatusKind       lastRejectReason;
+    DDS::QosPolicyId_t                  lastRequestedPolicy;
+    DDS::QosPolicyId_t                  lastOfferedPolicy;
+    pthread_mutex_t                     lock;           /* for the three above */
+
+    /* Events at the previous report. */
+    DDS::ULongLong                      reportedEvents;
+
+public:
+    /* Constructor */
+    StatusMonitor();
+
+    /* Destructor */
+    ~StatusMonitor();
+
+    /* Account for the changes in the statuses. */
+    void sampleLost(const DDS::SampleLostStatus &status);
+    void sampleRejected(const DDS::SampleRejectedStatus &status);
+    void requestedIncompatibleQos(const DDS::RequestedIncompatibleQosStatus &status);
+    void offeredIncompatibleQos(const DDS::OfferedIncompatibleQosStatus &status);
+    void requestedDeadlineMissed(const DDS::RequestedDeadlineMissedStatus &status);
+    void offeredDeadlineMissed(const DDS::OfferedDeadlineMissedStatus &status);
+    void livelinessLost(const DDS::LivelinessLostStatus &status);
+
+    /* Returns the number of events of all kinds so far. */
+    DDS::ULongLong getEvents() const;
+
+    /* Returns the events of one kind so far; requested and offered are added. */
+    DDS::ULongLong getSamplesLost() const;
+    DDS::ULongLong getSamplesRejected() const;
+    DDS::ULongLong getIncompatibleQos() const;
+    DDS::ULongLong getDeadlinesMissed() const;
+    DDS::ULongLong getLivelinessLosses() const;
+
+    /* Print the counts, and how many events there were since the previous report. */
+    void report(std::ostream &out);
+};
+
+/**
+ * DataReaderListener that counts the monitored statuses of the readers it
+ * is attached to. Listeners that take the data derive from it and override
+ * on_data_available.
+ **/
+class StatusReaderListener : public virtual DDS::DataReaderListener {
+
+protected:
+    StatusMonitor                       &monitor;
+
+public:
+    /* Constructor */
+    StatusReaderListener(StatusMonitor &monitor);
+
+    /* Callback method implementation. */
+    virtual void on_requested_deadline_missed (
+        DDS::DataReader_ptr reader,
+        const DDS::RequestedDeadlineMissedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_requested_incompatible_qos (
+        DDS::DataReader_ptr reader,
+        const DDS::RequestedIncompatibleQosStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_sample_rejected (
+        DDS::DataReader_ptr reader,
+        const DDS::SampleRejectedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_liveliness_changed (
+        DDS::DataReader_ptr reader,
+        const DDS::LivelinessChangedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_data_available (
+        DDS::DataReader_ptr reader
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_subscription_matched (
+        DDS::DataReader_ptr reader,
+        const DDS::SubscriptionMatchedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_sample_lost (
+        DDS::DataReader_ptr reader,
+        const DDS::SampleLostStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+/**
+ * DataWriterListener that counts the monitored statuses of the writers it
+ * is attached to.
+ **/
+class StatusWriterListener : public virtual DDS::DataWriterListener {
+
+    StatusMonitor                       &monitor;
+
+public:
+    /* Constructor */
+    StatusWriterListener(StatusMonitor &monitor);
+
+    /* Callback method implementation. */
+    virtual void on_offered_deadline_missed (
+        DDS::DataWriter_ptr writer,
+        const DDS::OfferedDeadlineMissedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_offered_incompatible_qos (
+        DDS::DataWriter_ptr writer,
+        const DDS::OfferedIncompatibleQosStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_liveliness_lost (
+        DDS::DataWriter_ptr writer,
+        const DDS::LivelinessLostStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+
+    virtual void on_publication_matched (
+        DDS::DataWriter_ptr writer,
+        const DDS::PublicationMatchedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/************************************************************************
+ * LOGICAL_NAME:    ThroughputMeter.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the meter that reports the
+ * received throughput per interval.
+ * 
+ ***/
+
+#include <iomanip>
+#include <math.h>
+
+#include "ThroughputMeter.h"
+#include "Timing.h"
+#include "Atomic.h"
+
+using namespace std;
+
+ThroughputMeter::ThroughputMeter()
+    : samples(0), bytes(0), takes(0),
+      reportedSamples(0), reportedBytes(0), reportedTakes(0),
+      intervalSamples(0), intervalRate(0.0), intervalByteRate(0.0),
+      intervals(0), rateMean(0.0), rateM2(0.0), rateMin(0.0), rateMax(0.0)
+{
+    startTime = currentTimeNanos();
+    reportedTime = startTime;
+}
+
+void ThroughputMeter::record(DDS::ULong takenSamples, DDS::ULongLong takenBytes)
+{
+    __sync_fetch_and_add(&samples, (DDS::ULongLong)takenSamples);
+    __sync_fetch_and_add(&bytes, takenBytes);
+    __sync_fetch_and_add(&takes, 1ULL);
+}
+
+bool ThroughputMeter::report(std::ostream &out)
+{
+    DDS::LongLong now = currentTimeNanos();
+    DDS::ULongLong nowSamples = atomicRead(samples);
+    DDS::ULongLong nowBytes = atomicRead(bytes);
+    DDS::ULongLong nowTakes = atomicRead(takes);
+    double seconds = nanosToSeconds(now - reportedTime);
+
+    if (seconds <= 0.0) {
+        return false;
+    }
+    DDS::ULongLong intervalTakes = nowTakes - reportedTakes;
+    intervalSamples = nowSamples - reportedSamples;
+    double rate = intervalSamples / seconds;
+    double byteRate = (nowBytes - reportedBytes) / seconds;
+    intervalRate = rate;
+    intervalByteRate = byteRate;
+
+    /* Fold this interval's rate into the running statistics. */
+    intervals++;
+    double delta = rate - rateMean;
+    rateMean += delta / intervals;
+    rateM2 += delta * (rate - rateMean);
+    if (intervals == 1 || rate < rateMin) {
+        rateMin = rate;
+    }
+    if (intervals == 1 || rate > rateMax) {
+        rateMax = rate;
+    }
+
+    out << "[" << fixed << setprecision(1) << nanosToSeconds(now - startTime) << " s] throughput: "
+        << intervalSamples << " samples, "
+        << rate << " samples/s, "
+        << byteRate << " bytes/s, "
+        << setprecision(2) << (intervalTakes ? (double)intervalSamples / intervalTakes : 0.0)
+        << " samples/take, rate CV " << getRateVariation() << endl;
+
+    reportedSamples = nowSamples;
+    reportedBytes = nowBytes;
+    reportedTakes = nowTakes;
+    reportedTime = now;
+    return true;
+}
+
+void ThroughputMeter::summary(std::ostream &out)
+{
+    double seconds = nanosToSeconds(currentTimeNanos() - startTime);
+    DDS::ULongLong nowSamples = atomicRead(samples);
+    DDS::ULongLong nowBytes = atomicRead(bytes);
+    DDS::ULongLong nowTakes = atomicRead(takes);
+
+    out << "Throughput: " << nowSamples << " samples, " << nowBytes << " bytes in "
+        << fixed << setprecision(1) << seconds << " s";
+    if (seconds > 0.0) {
+        out << ", " << nowSamples / seconds << " samples/s, " << nowBytes / seconds << " bytes/s";
+    }
+    out << ", " << setprecision(2) << (nowTakes ? (double)nowSamples / nowTakes : 0.0) << " samples/take" << endl;
+    if (intervals > 0) {
+        out << "  interval rates: min " << setprecision(1) << rateMin
+            << ", mean " << rateMean
+            << ", max " << rateMax
+            << ", CV " << setprecision(3) << getRateVariation()
+            << " over " << intervals << " intervals" << endl;
+    }
+}
+
+DDS::ULongLong ThroughputMeter::getSamples() const
+{
+    return atomicRead(samples);
+}
+
+DDS::ULongLong ThroughputMeter::getBytes() const
+{
+    return atomicRead(bytes);
+}
+
+DDS::ULongLong ThroughputMeter::getIntervalSamples() const
+{
+    return intervalSamples;
+}
+
+double ThroughputMeter::getIntervalRate() const
+{
+    return intervalRate;
+}
+
+double ThroughputMeter::getIntervalByteRate() const
+{
+    return intervalByteRate;
+}
+
+double ThroughputMeter::getRate() const
+{
+    double seconds = nanosToSeconds(currentTimeNanos() - startTime);
+
+    return seconds > 0.0 ? atomicRead(samples) / seconds : 0.0;
+}
+
+double ThroughputMeter::getByteRate() const
+{
+    double seconds = nanosToSeconds(currentTimeNanos() - startTime);
+
+    return seconds > 0.0 ? atomicRead(bytes) / seconds : 0.0;
+}
+
+double ThroughputMeter::getRateVariation() const
+{
+    if (intervals < 2 || rateMean <= 0.0) {
+        return 0.0;
+    }
+    return sqrt(rateM2 / (intervals - 1)) / rateMean;
+}
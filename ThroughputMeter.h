@@ -0,0 +1,82 @@
+/************************************************************************
+ * LOGICAL_NAME:    ThroughputMeter.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the meter that reports the received
+ * throughput per interval.
+ * 
+ ***/
+
+#ifndef __THROUGHPUTMETER_H__
+#define __THROUGHPUTMETER_H__
+
+#include <iostream>
+
+#include "ccpp_dds_dcps.h"
+
+/**
+ * Counts received samples, payload bytes and takes. Every report covers the
+ * interval since the previous one and keeps track of how stable the rate is
+ * across intervals (coefficient of variation), so receiver stalls and
+ * throughput collapse stand out in long runs. Recording is lock-free, the
+ * reports are made by a single thread.
+ **/
+class ThroughputMeter {
+
+    /* Totals, updated by the receive thread(s). */
+    DDS::ULongLong                      samples;
+    DDS::ULongLong                      bytes;
+    DDS::ULongLong                      takes;
+
+    /* Totals at the previous report. */
+    DDS::ULongLong                      reportedSamples;
+    DDS::ULongLong                      reportedBytes;
+    DDS::ULongLong                      reportedTakes;
+    DDS::LongLong                       startTime;
+    DDS::LongLong                       reportedTime;
+
+    /* The interval of the previous report. */
+    DDS::ULongLong                      intervalSamples;
+    double                              intervalRate;
+    double                              intervalByteRate;
+
+    /* Running mean and variance of the interval rates (Welford). */
+    DDS::ULong                          intervals;
+    double                              rateMean;
+    double                              rateM2;
+    double                              rateMin;
+    double                              rateMax;
+
+public:
+    /* Constructor */
+    ThroughputMeter();
+
+    /* Account for one take that delivered the given samples and payload bytes. */
+    void record(DDS::ULong takenSamples, DDS::ULongLong takenBytes);
+
+    /* Print the rates of the interval since the previous report; false when no time has passed and nothing was reported. */
+    bool report(std::ostream &out);
+
+    /* Print the rates over the whole run and their stability across intervals. */
+    void summary(std::ostream &out);
+
+    DDS::ULongLong getSamples() const;
+    DDS::ULongLong getBytes() const;
+
+    /* Returns the samples and rates of the interval of the previous report. */
+    DDS::ULongLong getIntervalSamples() const;
+    double getIntervalRate() const;
+    double getIntervalByteRate() const;
+
+    /* Returns the rates over the whole run. */
+    double getRate() const;
+    double getByteRate() const;
+
+    /* Returns the coefficient of variation of the interval rates (0 when unknown). */
+    double getRateVariation() const;
+};
+
+#endif
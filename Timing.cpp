@@ -0,0 +1,177 @@
+/************************************************************************
+ * LOGICAL_NAME:    Timing.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the clock and resource usage
+ * operations used by the measurement code.
+ * 
+ ***/
+
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "Timing.h"
+
+#define NANOS_PER_SEC 1000000000LL
+
+/**
+ * Returns the current wall-clock time in nanoseconds.
+ **/
+DDS::LongLong currentTimeNanos()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (DDS::LongLong)now.tv_sec * NANOS_PER_SEC + now.tv_nsec;
+}
+
+/**
+ * Returns the CPU time consumed by all threads of this process so far.
+ **/
+DDS::LongLong processCpuNanos()
+{
+    struct timespec used;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &used);
+    return (DDS::LongLong)used.tv_sec * NANOS_PER_SEC + used.tv_nsec;
+}
+
+/**
+ * Returns the time stamp counter, or the monotonic clock in nanoseconds.
+ **/
+DDS::ULongLong readCycles()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    unsigned int low;
+    unsigned int high;
+
+    __asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+    return ((DDS::ULongLong)high << 32) | low;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (DDS::ULongLong)now.tv_sec * NANOS_PER_SEC + now.tv_nsec;
+#endif
+}
+
+/**
+ * Returns the rate of readCycles(), calibrated against the monotonic clock
+ * over 10 ms the first time it is called.
+ **/
+double cyclesPerNano()
+{
+    static double rate = 0.0;
+    struct timespec start;
+    struct timespec now;
+    DDS::ULongLong startCycles;
+    DDS::LongLong elapsed;
+
+    if (rate == 0.0) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        startCycles = readCycles();
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            elapsed = (DDS::LongLong)(now.tv_sec - start.tv_sec) * NANOS_PER_SEC +
+                now.tv_nsec - start.tv_nsec;
+        } while (elapsed < 10000000LL);
+        rate = (double)(readCycles() - startCycles) / elapsed;
+    }
+    return rate;
+}
+
+/**
+ * Returns the resident memory of this process, from /proc/self/statm.
+ **/
+DDS::LongLong residentBytes()
+{
+    FILE *statm;
+    long size = 0;
+    long resident = 0;
+
+    statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL) {
+        return 0;
+    }
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(statm);
+    return (DDS::LongLong)resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Converts a DDS timestamp into nanoseconds.
+ **/
+DDS::LongLong toNanos(const DDS::Time_t &time)
+{
+    return (DDS::LongLong)time.sec * NANOS_PER_SEC + time.nanosec;
+}
+
+/**
+ * Converts a number of seconds into nanoseconds.
+ **/
+DDS::LongLong secondsToNanos(double seconds)
+{
+    return (DDS::LongLong)(seconds * NANOS_PER_SEC);
+}
+
+/**
+ * Converts nanoseconds into a DDS duration.
+ **/
+DDS::Duration_t toDuration(DDS::LongLong nanos)
+{
+    DDS::Duration_t duration;
+
+    duration.sec = (DDS::Long)(nanos / NANOS_PER_SEC);
+    duration.nanosec = (DDS::ULong)(nanos % NANOS_PER_SEC);
+    return duration;
+}
+
+/**
+ * Converts nanoseconds into (fractional) seconds.
+ **/
+double nanosToSeconds(DDS::LongLong nanos)
+{
+    return (double)nanos / NANOS_PER_SEC;
+}
+
+/**
+ * Busy-waits for the given number of nanoseconds of thread CPU time.
+ **/
+void spinNanos(DDS::LongLong nanos)
+{
+    struct timespec used;
+    DDS::LongLong end;
+    DDS::LongLong now;
+
+    if (nanos <= 0) {
+        return;
+    }
+    /* Thread CPU time: being preempted does not count as work done. */
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &used);
+    end = (DDS::LongLong)used.tv_sec * NANOS_PER_SEC + used.tv_nsec + nanos;
+    do {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &used);
+        now = (DDS::LongLong)used.tv_sec * NANOS_PER_SEC + used.tv_nsec;
+    } while (now < end);
+}
+
+/**
+ * Sleeps until the wall-clock time reaches the given nanoseconds.
+ **/
+void sleepUntilNanos(DDS::LongLong deadline)
+{
+    struct timespec until;
+
+    until.tv_sec = deadline / NANOS_PER_SEC;
+    until.tv_nsec = deadline % NANOS_PER_SEC;
+
+    /* Absolute, so an interrupted sleep can simply be resumed. */
+    while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &until, NULL) == EINTR) { }
+}
@@ -0,0 +1,77 @@
+/************************************************************************
+ * LOGICAL_NAME:    Timing.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the clock and resource usage
+ * operations used by the measurement code.
+ * 
+ ***/
+
+#ifndef __TIMING_H__
+#define __TIMING_H__
+
+#include "ccpp_dds_dcps.h"
+
+/**
+ * Returns the current wall-clock time in nanoseconds. This is the clock
+ * DDS uses for source timestamps, so the two can be subtracted.
+ **/
+DDS::LongLong currentTimeNanos();
+
+/**
+ * Returns the CPU time consumed by all threads of this process so far, in
+ * nanoseconds.
+ **/
+DDS::LongLong processCpuNanos();
+
+/**
+ * Returns a cycle counter for timing short stretches of code: the time
+ * stamp counter where the CPU has one, nanoseconds otherwise.
+ **/
+DDS::ULongLong readCycles();
+
+/**
+ * Returns how many readCycles() units pass per nanosecond (measured once).
+ **/
+double cyclesPerNano();
+
+/**
+ * Returns the resident memory of this process in bytes (0 if unknown).
+ **/
+DDS::LongLong residentBytes();
+
+/**
+ * Converts a DDS timestamp into nanoseconds.
+ **/
+DDS::LongLong toNanos(const DDS::Time_t &time);
+
+/**
+ * Converts a number of seconds into nanoseconds.
+ **/
+DDS::LongLong secondsToNanos(double seconds);
+
+/**
+ * Converts nanoseconds into a DDS duration, e.g. for a WaitSet timeout.
+ **/
+DDS::Duration_t toDuration(DDS::LongLong nanos);
+
+/**
+ * Converts nanoseconds into (fractional) seconds.
+ **/
+double nanosToSeconds(DDS::LongLong nanos);
+
+/**
+ * Keeps the calling thread busy on the CPU for the given number of
+ * nanoseconds; a stand-in for the real work done per sample.
+ **/
+void spinNanos(DDS::LongLong nanos);
+
+/**
+ * Sleeps until currentTimeNanos() reaches the given deadline.
+ **/
+void sleepUntilNanos(DDS::LongLong deadline);
+
+#endif
@@ -23,35 +23,61 @@
 
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include <unistd.h>
 #include <string.h>
-#include <pthread.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <signal.h>
 
 #include "ccpp_dds_dcps.h"
 #include "CheckStatus.h"
 #include "ccpp_Chat.h"
+#include "ThroughputMeter.h"
+#include "StatusMonitor.h"
+#include "Histogram.h"
+#include "Timing.h"
+#include "StatsEmitter.h"
+#include "DepartureAccounting.h"
+#include "WriterDepartures.h"
+#include "HeavyHitters.h"
+
+#define REPORT_PERIOD   10.0  /* seconds between throughput reports */
+#define RUN_DURATION    60.0  /* seconds until the UserLoad terminates */
+#define COUNT_DEPTH     256   /* history per user when the messages are only counted */
+#define TALKER_COUNTERS 100   /* users monitored for the top talkers */
+#define TOP_TALKERS     10    /* top talkers reported */
+#define SIGNAL_POLL     1.0   /* seconds at most until a termination signal is noticed */
 
 using namespace DDS;
 using namespace Chat;
 
-/* entities required by all threads. */
-static DDS::GuardCondition_var          escape;
+/* Set by SIGINT or SIGTERM: end the run as if its duration had passed. */
+static volatile sig_atomic_t terminationRequested = 0;
 
-/* Sleeper thread: sleeps 60 seconds and then triggers the WaitSet. */
-extern "C" void *
-delayedEscape(
-    void *arg)
+extern "C" void
+onTerminate(
+    int signum)
 {
-    DDS::ReturnCode_t status;
-    
-    sleep(60);     /* wait for 60 sec. */
-    status = escape->set_trigger_value(TRUE);
-    checkStatus(status, "DDS::GuardCondition::set_trigger_value");
-
-    return NULL;
+    terminationRequested = 1;
 }
 
+/**
+ * Records the messages a counting accounting consumes in the top talkers.
+ **/
+class TalkerHook : public ConsumeHook {
+
+    HeavyHitters                        &talkers;
+
+public:
+    TalkerHook(HeavyHitters &talkers) : talkers(talkers) {}
+
+    virtual void consumed(DDS::Long userID, DDS::ULong length)
+    {
+        talkers.record(userID, length);
+    }
+};
+
 int
 main (
     int argc,
@@ -63,17 +89,16 @@ main (
     Topic_var                       nameServiceTopic;
     Subscriber_var                  chatSubscriber;
     DataReader_ptr                  parentReader;
-    QueryCondition_var              singleUser;
     ReadCondition_var               newUser;
-    StatusCondition_var             leftUser;
+    ReadCondition_var               newMessages;
     WaitSet_var                     userLoadWS;
-    LivelinessChangedStatus         livChangStatus;
 
     /* QosPolicy holders */
     TopicQos                        setting_topic_qos;
     TopicQos                        reliable_topic_qos;
     SubscriberQos                   sub_qos;
     DataReaderQos                   message_qos;
+    DataReaderQos                   ns_qos;
 
     /* DDS Identifiers */
     DomainId_t                      domain = NULL;
@@ -91,14 +116,100 @@ main (
     SampleInfoSeq                   infoSeq2;
 
     /* Others */
-    StringSeq                       args;
     char *                          chatMessageTypeName = NULL;
     char *                          nameServiceTypeName = NULL;
 
     bool                            closed = false;
-    Long                            prevCount = 0;
-    pthread_t                       tid;
-    pthread_attr_t                  tattr;
+    ThroughputMeter                 meter;
+    StatusMonitor                   monitor;
+    StatusReaderListener            *readerStatus;
+    WriterDepartures                *writerDepartures;
+    GuardCondition_ptr              writersLost;
+    LongLong                        reportPeriod = secondsToNanos(REPORT_PERIOD);
+    LongLong                        nextReport;
+    LongLong                        runDuration = secondsToNanos(RUN_DURATION);
+    LongLong                        endTime = 0;
+    LongLong                        wakeUp;
+    LongLong                        now;
+    LongLong                        startTime;
+    LongLong                        detection;
+    Histogram                       presence;
+    ULong                           historicalUsers = 0;
+    const char *                    durabilityKind = NULL;
+    StatsEmitter                    *stats = NULL;
+    const char *                    accountingKind = "bulk";
+    DepartureAccounting             *accounting;
+    std::vector<Departure>          departures;
+    std::vector<Long>               departedIDs;
+    ULongLong                       unresolved = 0;
+    Long                            presentUsers = 0;
+    double                          heldPerUser;
+    ULong                           talkerCounters = TALKER_COUNTERS;
+    HeavyHitters                    *talkers = NULL;
+    TalkerHook                      *talkerHook = NULL;
+    char                            *end;
+    bool                            counting;
+    int                             opt;
+
+    /* Options: -r <seconds between throughput reports>. */
+    /* -d <seconds to run>, 0 to run until interrupted; SIGINT and SIGTERM
+       end any run with the usual summary. */
+    /* -t <counters> for the top talkers: every user sending more than
+       1/counters of the messages is reported; "off" turns the tracking off. */
+    /* -D volatile|transient_local|transient sets the durability with which
+       the names are read; by default that of the topic (transient). */
+    /* -J <file or fd:N> also writes the reports, the arrivals and departures
+       of users and a summary as JSON lines. */
+    /* -a legacy|bulk|count selects how the messages of departed users are
+       counted: per user with a query, with one take for all of them, or by
+       taking them as they arrive and only keeping a count per user. */
+    while ((opt = getopt(argc, argv, "r:d:D:t:J:a:")) != -1) {
+        switch (opt) {
+        case 'r':
+            reportPeriod = secondsToNanos(atof(optarg));
+            break;
+        case 'd':
+            runDuration = secondsToNanos(atof(optarg));
+            break;
+        case 'D':
+            durabilityKind = optarg;
+            break;
+        case 't':
+            if (strcmp(optarg, "off") == 0) {
+                talkerCounters = 0;
+                break;
+            }
+            /* A negative count would wrap to a huge one and exhaust the memory. */
+            talkerCounters = strtoul(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || optarg[0] == '-' || talkerCounters == 0) {
+                cerr << "The number of talker counters must be positive, or off." << endl;
+                exit(-1);
+            }
+            break;
+        case 'J':
+            stats = new StatsEmitter(optarg, "UserLoad");
+            break;
+        case 'a':
+            accountingKind = optarg;
+            break;
+        default:
+            cerr << "Usage: " << argv[0] << " [-r reportPeriod] [-d duration] [-D volatile|transient_local|transient] [-t counters|off] [-J statsFile|fd:N] [-a legacy|bulk|count]" << endl;
+            exit(-1);
+        }
+    }
+    if (reportPeriod <= 0) {
+        cerr << "The report period must be positive." << endl;
+        exit(-1);
+    }
+    if (runDuration < 0) {
+        cerr << "The duration must not be negative." << endl;
+        exit(-1);
+    }
+    counting = !DepartureAccounting::needsHistory(accountingKind);
+    if (talkerCounters > 0) {
+        talkers = new HeavyHitters(talkerCounters, TOP_TALKERS);
+        talkerHook = new TalkerHook(*talkers);
+    }
     
     printf("Starting UserLoad example.\n");
     fflush(stdout);
@@ -167,49 +278,77 @@ main (
     chatSubscriber = participant->create_subscriber(sub_qos, NULL, STATUS_MASK_NONE);
     checkHandle(chatSubscriber.in(), "DDS::DomainParticipant::create_subscriber");
     
+    /* All DataReaders count lost and rejected samples, missed deadlines and incompatible QoS. */
+    readerStatus = new StatusReaderListener(monitor);
+    checkHandle(readerStatus, "new StatusReaderListener");
+
+    /* The ChatMessageDataReader also tells which writers, and so which users, left. */
+    writerDepartures = new WriterDepartures(monitor);
+    checkHandle(writerDepartures, "new WriterDepartures");
+
+    /* Adapt the DataReaderQos for the NameServiceDataReader to the durability requested. */
+    status = chatSubscriber->get_default_datareader_qos(ns_qos);
+    checkStatus(status, "DDS::Subscriber::get_default_datareader_qos");
+    status = chatSubscriber->copy_from_topic_qos(ns_qos, setting_topic_qos);
+    checkStatus(status, "DDS::Subscriber::copy_from_topic_qos");
+    if (durabilityKind) {
+        if (strcmp(durabilityKind, "volatile") == 0) {
+            ns_qos.durability.kind = VOLATILE_DURABILITY_QOS;
+        } else if (strcmp(durabilityKind, "transient_local") == 0) {
+            ns_qos.durability.kind = TRANSIENT_LOCAL_DURABILITY_QOS;
+        } else if (strcmp(durabilityKind, "transient") == 0) {
+            ns_qos.durability.kind = TRANSIENT_DURABILITY_QOS;
+        } else {
+            cerr << "Unknown durability: " << durabilityKind << endl;
+            exit(-1);
+        }
+    }
+
     /* Create a DataReader for the NameService Topic (using the appropriate QoS). */
     parentReader = chatSubscriber->create_datareader( 
         nameServiceTopic.in(), 
-        DATAREADER_QOS_USE_TOPIC_QOS, 
-        NULL,
-        STATUS_MASK_NONE);
+        ns_qos, 
+        readerStatus,
+        MONITORED_READER_STATUS);
     checkHandle(parentReader, "DDS::Subscriber::create_datareader (NameService)");
 
     /* Narrow the abstract parent into its typed representative. */
     nameServer = NameServiceDataReader::_narrow(parentReader);
     checkHandle(nameServer.in(), "Chat::NameServiceDataReader::_narrow");
     
-    /* Adapt the DataReaderQos for the ChatMessageDataReader to keep track of all messages. */
+    /* Adapt the DataReaderQos for the ChatMessageDataReader to keep track of all messages,
+       unless they are counted as they arrive: then a burst per user is enough. */
     status = chatSubscriber->get_default_datareader_qos(message_qos);
     checkStatus(status, "DDS::Subscriber::get_default_datareader_qos");
     status = chatSubscriber->copy_from_topic_qos(message_qos, reliable_topic_qos);
     checkStatus(status, "DDS::Subscriber::copy_from_topic_qos");
-    message_qos.history.kind = KEEP_ALL_HISTORY_QOS;
+    if (counting) {
+        message_qos.history.kind = KEEP_LAST_HISTORY_QOS;
+        message_qos.history.depth = COUNT_DEPTH;
+    } else {
+        message_qos.history.kind = KEEP_ALL_HISTORY_QOS;
+    }
 
     /* Create a DataReader for the ChatMessage Topic (using the appropriate QoS). */
     parentReader = chatSubscriber->create_datareader( 
         chatMessageTopic.in(), 
         message_qos, 
-        NULL,
-        STATUS_MASK_NONE);
+        writerDepartures,
+        MONITORED_READER_STATUS | LIVELINESS_CHANGED_STATUS);
     checkHandle(parentReader, "DDS::Subscriber::create_datareader (ChatMessage)");
     
     /* Narrow the abstract parent into its typed representative. */
     loadAdmin = ChatMessageDataReader::_narrow(parentReader);
     checkHandle(loadAdmin.in(), "Chat::ChatMessageDataReader::_narrow");
     
-    /* Initialize the Query Arguments. */
-    args.length(1);
-    args[0UL] = "0";
-    
-    /* Create a QueryCondition that will contain all messages with userID=ownID */
-    singleUser = loadAdmin->create_querycondition( 
-        ANY_SAMPLE_STATE, 
-        ANY_VIEW_STATE, 
-        ANY_INSTANCE_STATE, 
-        "userID=%0", 
-        args);
-    checkHandle(singleUser.in(), "DDS::DataReader::create_querycondition");
+    /* Count the messages of the users that leave, the way selected. */
+    accounting = DepartureAccounting::create(accountingKind, nameServer.in(), loadAdmin.in());
+    if (!accounting) {
+        cerr << "Unknown departure accounting: " << accountingKind << endl;
+        exit(-1);
+    }
+    accounting->setWriters(writerDepartures);
+    accounting->setConsumeHook(talkerHook);
     
     /* Create a ReadCondition that will contain new users only */
     newUser = nameServer->create_readcondition( 
@@ -218,23 +357,24 @@ main (
         ALIVE_INSTANCE_STATE);
     checkHandle(newUser.in(), "DDS::DataReader::create_readcondition");
 
-    /* Obtain a StatusCondition that triggers only when a Writer changes Liveliness */
-    leftUser = loadAdmin->get_statuscondition();
-    checkHandle(leftUser.in(), "DDS::DataReader::get_statuscondition");
-    status = leftUser->set_enabled_statuses(LIVELINESS_CHANGED_STATUS);
-    checkStatus(status, "DDS::StatusCondition::set_enabled_statuses");
+    /* Create a ReadCondition that will contain the messages not metered yet */
+    newMessages = loadAdmin->create_readcondition( 
+        NOT_READ_SAMPLE_STATE, 
+        ANY_VIEW_STATE, 
+        ANY_INSTANCE_STATE);
+    checkHandle(newMessages.in(), "DDS::DataReader::create_readcondition");
 
-    /* Create a bare guard which will be used to close the room */
-    escape = new GuardCondition();
+    /* Obtain the GuardCondition that triggers when a Writer lost its Liveliness */
+    writersLost = writerDepartures->getCondition();
 
     /* Create a waitset and add the ReadConditions */
     userLoadWS = new WaitSet();
     status = userLoadWS->attach_condition(newUser.in());
     checkStatus(status, "DDS::WaitSet::attach_condition (newUser)");
-    status = userLoadWS->attach_condition(leftUser.in());
-    checkStatus(status, "DDS::WaitSet::attach_condition (leftUser)");
-    status = userLoadWS->attach_condition(escape.in());
-    checkStatus(status, "DDS::WaitSet::attach_condition (escape)");
+    status = userLoadWS->attach_condition(writersLost);
+    checkStatus(status, "DDS::WaitSet::attach_condition (writersLost)");
+    status = userLoadWS->attach_condition(newMessages.in());
+    checkStatus(status, "DDS::WaitSet::attach_condition (newMessages)");
  
     /* Initialize and pre-allocate the GuardList used to obtain the triggered Conditions. */
     guardList.length(3);
@@ -251,15 +391,65 @@ main (
     status = nameServer->return_loan(nsList, infoSeq);
     checkStatus(status, "Chat::NameServiceDataReader::return_loan");
     
-    /* Start the sleeper thread. */
-    pthread_attr_init(&tattr);
-    pthread_attr_setdetachstate(&tattr, PTHREAD_CREATE_DETACHED);
-    pthread_create (&tid, &tattr, delayedEscape, NULL);
-    pthread_attr_destroy(&tattr);
-
+    /* The timeout of the WaitSet ends the run and drives the reports. */
+    now = currentTimeNanos();
+    startTime = now;
+    nextReport = now + reportPeriod;
+    if (runDuration > 0) {
+        endTime = now + runDuration;
+    }
+    signal(SIGINT, onTerminate);
+    signal(SIGTERM, onTerminate);
     while (!closed) {
-        /* Wait until at least one of the Conditions in the waitset triggers. */
-        status = userLoadWS->wait(guardList, DURATION_INFINITE);
+        /* Wait until at least one of the Conditions in the waitset triggers, a report is due or the run ends. */
+        now = currentTimeNanos();
+        if ((endTime > 0 && now >= endTime) || terminationRequested) {
+            cout << "UserLoad has terminated." << endl;
+            closed = true;
+            continue;
+        }
+        if (now >= nextReport) {
+            /* Without a new interval the meter would hand out the previous one again. */
+            bool interval = meter.report(cout);
+            monitor.report(cout);
+            heldPerUser = presentUsers > 0 ? (double)accounting->getHeldBytes() / presentUsers : 0.0;
+            cout << "Memory: " << residentBytes() / 1024 << " kB resident, " <<
+                accounting->getUsers() << " users counted (" << accountingKind << "), " <<
+                accounting->getHeldBytes() / 1024 << " kB held for " << presentUsers << " users (" <<
+                (ULongLong)heldPerUser << " bytes per user)." << endl;
+            if (stats && interval) {
+                stats->begin("interval");
+                stats->integer("samples", meter.getIntervalSamples());
+                stats->number("samples_per_s", meter.getIntervalRate());
+                stats->number("bytes_per_s", meter.getIntervalByteRate());
+                stats->statuses(monitor);
+                stats->text("accounting", accountingKind);
+                stats->integer("counted_users", accounting->getUsers());
+                stats->integer("held_bytes", accounting->getHeldBytes());
+                stats->number("held_bytes_per_user", heldPerUser);
+                stats->end();
+            }
+            if (talkers) {
+                talkers->report(cout, stats);
+            }
+            /* Keep the reports on their period over a long run, unless they fell behind. */
+            nextReport += reportPeriod;
+            if (nextReport <= now) {
+                nextReport = now + reportPeriod;
+            }
+        }
+        wakeUp = nextReport;
+        if (endTime > 0 && endTime < wakeUp) {
+            wakeUp = endTime;
+        }
+        /* The signal does not wake the WaitSet, so look at it regularly. */
+        if (now + secondsToNanos(SIGNAL_POLL) < wakeUp) {
+            wakeUp = now + secondsToNanos(SIGNAL_POLL);
+        }
+        status = userLoadWS->wait(guardList, toDuration(wakeUp - now));
+        if (status == RETCODE_TIMEOUT) {
+            continue;
+        }
         checkStatus(status, "DDS::WaitSet::wait");
 
         /* Walk over all guards to display information */
@@ -273,58 +463,105 @@ main (
                     newUser.in() );
                 checkStatus(status, "Chat::NameServiceDataReader::read_w_condition");
                 
+                /* The source timestamp is the time the user was announced. Names
+                   announced before the UserLoad started came from the durability
+                   service, so their delay says nothing about the detection. */
+                now = currentTimeNanos();
+                presentUsers += nsList.length();
                 for (ULong j = 0; j < nsList.length(); j++) {
+                    bool historical = toNanos(infoSeq[j].source_timestamp) < startTime;
+
+                    detection = now - toNanos(infoSeq[j].source_timestamp);
+                    if (historical) {
+                        historicalUsers++;
+                    } else {
+                        presence.record(detection);
+                    }
                     cout << "New user: " << nsList[j].name << endl;
+                    if (stats) {
+                        stats->begin("arrival");
+                        stats->integer("userID", nsList[j].userID);
+                        stats->text("name", nsList[j].name);
+                        stats->integer("detection_ns", detection);
+                        stats->integer("historical", historical);
+                        stats->end();
+                    }
                 }
                 status = nameServer->return_loan(nsList, infoSeq);
                 checkStatus(status, "Chat::NameServiceDataReader::return_loan");
 
-            } else if ( guardList[i].in() == leftUser.in() ) {
-                /* Some liveliness has changed (either a DataWriter joined or a DataWriter left) */
-                status = loadAdmin->get_liveliness_changed_status(livChangStatus);
-                checkStatus(status, "DDS::DataReader::get_liveliness_changed_status");
-                if (livChangStatus.alive_count < prevCount) {
-                    /* A user has left the ChatRoom, since a DataWriter lost its liveliness */
-                    /* Take the effected users so tey will not appear in the list later on. */
-                    status = nameServer->take( 
-                        nsList, 
-                        infoSeq, 
+            } else if ( guardList[i].in() == writersLost ) {
+                /* DataWriters lost their liveliness: the users they wrote for have left the ChatRoom */
+                departedIDs.clear();
+                departures.clear();
+                writerDepartures->departedUsers(departedIDs);
+                for (ULong j = 0; j < departedIDs.size(); j++) {
+                    accounting->depart(departedIDs[j], departures);
+                }
+
+                /* Losses that could not be attributed fall back to a scan of the names. */
+                if (writerDepartures->getUnattributed() + writerDepartures->getUnknownWriters() > unresolved) {
+                    unresolved = writerDepartures->getUnattributed() + writerDepartures->getUnknownWriters();
+                    accounting->collect(departures);
+                }
+
+                presentUsers -= departures.size();
+                if (presentUsers < 0) {
+                    presentUsers = 0;
+                }
+                for (ULong j = 0; j < departures.size(); j++) {
+                    /* Display the user and his history */
+                    cout << "Departed user " << departures[j].name << " has sent " << 
+                        departures[j].messages << " messages";
+                    if (departures[j].missed > 0) {
+                        cout << " (" << departures[j].missed << " overwritten before counted)";
+                    }
+                    cout << "." << endl;
+                    if (stats) {
+                        stats->begin("departure");
+                        stats->integer("userID", departures[j].userID);
+                        stats->text("name", departures[j].name.c_str());
+                        stats->integer("messages", departures[j].messages);
+                        stats->integer("missed", departures[j].missed);
+                        stats->end();
+                    }
+                }
+
+            } else if ( guardList[i].in() == newMessages.in() ) {
+                ULong valid = 0;
+                ULongLong payload = 0;
+
+                if (counting) {
+                    /* Count and take the new messages, which frees their history. */
+                    accounting->consume(valid, payload);
+                } else {
+                    /* Meter the new messages; they stay in the history for the departure count. */
+                    status = loadAdmin->read_w_condition( 
+                        msgList, 
+                        infoSeq2, 
                         LENGTH_UNLIMITED, 
-                        ANY_SAMPLE_STATE, 
-                        ANY_VIEW_STATE, 
-                        NOT_ALIVE_NO_WRITERS_INSTANCE_STATE);
-                    checkStatus(status, "Chat::NameServiceDataReader::take");
-    
-                    for (ULong j = 0; j < nsList.length(); j++) {
-                        /* re-apply query arguments */
-                        ostringstream numberString;
-                        numberString << nsList[j].userID;
-                        args[0UL] = numberString.str().c_str();
-                        status = singleUser->set_query_parameters(args);
-                        checkStatus(status, "DDS::QueryCondition::set_query_parameters");
-    
-                        /* Read this users history */
-                        status = loadAdmin->take_w_condition( 
-                            msgList, 
-                            infoSeq2, 
-                            LENGTH_UNLIMITED, 
-                            singleUser.in() );
-                        checkStatus(status, "Chat::ChatMessageDataReader::take_w_condition");
-                        
-                        /* Display the user and his history */
-                        cout << "Departed user " << nsList[j].name << " has sent " << 
-                            msgList.length() << " messages." << endl;
-                        status = loadAdmin->return_loan(msgList, infoSeq2);
-                        checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+                        newMessages.in() );
+                    checkStatus(status, "Chat::ChatMessageDataReader::read_w_condition");
+
+                    for (ULong j = 0; j < msgList.length(); j++) {
+                        if (infoSeq2[j].valid_data) {
+                            ULong length = strlen(msgList[j].content);
+
+                            payload += length;
+                            valid++;
+                            if (talkers) {
+                                talkers->record(msgList[j].userID, length);
+                            }
+                            /* Not only for new instances: a restarted Chatter reuses the instance of its user. */
+                            writerDepartures->userSeen(infoSeq2[j].publication_handle, msgList[j].userID);
+                        }
                     }
-                    status = nameServer->return_loan(nsList, infoSeq);
-                    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+                    status = loadAdmin->return_loan(msgList, infoSeq2);
+                    checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+                    accounting->retain(valid, payload);
                 }
-                prevCount = livChangStatus.alive_count;
+                meter.record(valid, payload);
 
-            } else if ( guardList[i].in() == escape.in() ) {
-                cout << "UserLoad has terminated." << endl;
-                closed = true;
             }
             else
             {
@@ -333,13 +570,58 @@ main (
         } /* for */
     } /* while (!closed) */
 
+    meter.summary(cout);
+    monitor.report(cout);
+    cout << "Presence detection (us): ";
+    presence.print(cout, 1000.0);
+    cout << endl << historicalUsers << " users were known before the start." << endl;
+    heldPerUser = presentUsers > 0 ? (double)accounting->getHeldBytes() / presentUsers : 0.0;
+    cout << "Memory: " << residentBytes() / 1024 << " kB resident at the end, " <<
+        accounting->getUsers() << " users counted (" << accountingKind << "), " <<
+        accounting->getHeldBytes() / 1024 << " kB held for " << presentUsers << " users (" <<
+        (ULongLong)heldPerUser << " bytes per user)." << endl;
+    if (accounting->getLate() > 0) {
+        cout << accounting->getLate() << " messages arrived after their user was reported." << endl;
+    }
+    if (talkers) {
+        talkers->report(cout, stats);
+    }
+    cout << "Writer losses not attributed to users: " << writerDepartures->getUnattributed() <<
+        " folded, " << writerDepartures->getUnknownWriters() << " without messages." << endl;
+    if (stats) {
+        stats->begin("summary");
+        stats->integer("samples", meter.getSamples());
+        stats->integer("bytes", meter.getBytes());
+        stats->number("samples_per_s", meter.getRate());
+        stats->number("bytes_per_s", meter.getByteRate());
+        stats->number("rate_cv", meter.getRateVariation());
+        stats->statuses(monitor);
+        stats->text("accounting", accountingKind);
+        stats->integer("counted_users", accounting->getUsers());
+        stats->integer("held_bytes", accounting->getHeldBytes());
+        stats->number("held_bytes_per_user", heldPerUser);
+        stats->integer("late_messages", accounting->getLate());
+        stats->text("durability", durabilityKind ? durabilityKind : "topic");
+        stats->histogram("presence_detection_us", presence, 1000.0);
+        stats->integer("historical_users", historicalUsers);
+        stats->integer("unattributed_losses", writerDepartures->getUnattributed());
+        stats->integer("unknown_writers", writerDepartures->getUnknownWriters());
+        stats->end();
+        delete stats;
+    }
+
     /* Remove all Conditions from the WaitSet. */
-    status = userLoadWS->detach_condition( escape.in() );
-    checkStatus(status, "DDS::WaitSet::detach_condition (escape)");
-    status = userLoadWS->detach_condition( leftUser.in() );
-    checkStatus(status, "DDS::WaitSet::detach_condition (leftUser)");
+    status = userLoadWS->detach_condition( newMessages.in() );
+    checkStatus(status, "DDS::WaitSet::detach_condition (newMessages)");
+    status = userLoadWS->detach_condition( writersLost );
+    checkStatus(status, "DDS::WaitSet::detach_condition (writersLost)");
     status = userLoadWS->detach_condition( newUser.in() );
     checkStatus(status, "DDS::WaitSet::detach_condition (newUser)");
+    status = loadAdmin->delete_readcondition( newMessages.in() );
+    checkStatus(status, "DDS::DataReader::delete_readcondition (newMessages)");
+    delete accounting;
+    delete talkerHook;
+    delete talkers;
 
     /* Remove the type-names. */
     string_free(chatMessageTypeName);
@@ -348,6 +630,8 @@ main (
     /* Free all resources */
     status = participant->delete_contained_entities();
     checkStatus(status, "DDS::DomainParticipant::delete_contained_entities");
+    DDS::release(readerStatus);
+    DDS::release(writerDepartures);
     status = TheParticipantFactory->delete_participant( participant.in() );
     checkStatus(status, "DDS::DomainParticipantFactory::delete_participant");
     
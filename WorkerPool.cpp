@@ -0,0 +1,189 @@
+/************************************************************************
+ * LOGICAL_NAME:    WorkerPool.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for the pool of threads that
+ * process the messages taken by the MessageBoard.
+ * 
+ ***/
+
+#include <iomanip>
+
+#include "WorkerPool.h"
+#include "CheckStatus.h"
+#include "Timing.h"
+
+WorkerPool::WorkerPool(
+    DDS::ULong threads,
+    DDS::ULong depth,
+    DDS::LongLong workCost,
+    Histogram &completion
+) : workCost(workCost), completion(completion), depth(depth), waits(0), running(true)
+{
+    for (DDS::ULong i = 0; i < threads; i++) {
+        Worker *worker = new Worker();
+        worker->pool = this;
+        worker->id = i;
+        worker->inFlight = 0;
+        worker->stopping = false;
+        worker->processed = 0;
+        worker->maxDepth = 0;
+        worker->busy = 0;
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->ready, NULL);
+        pthread_cond_init(&worker->space, NULL);
+        workers.push_back(worker);
+    }
+    for (DDS::ULong i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i]->thread, NULL, workerThread, workers[i]) != 0) {
+            cerr << "Error in starting worker thread " << i << endl;
+            exit(-1);
+        }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+    for (DDS::ULong i = 0; i < workers.size(); i++) {
+        pthread_cond_destroy(&workers[i]->space);
+        pthread_cond_destroy(&workers[i]->ready);
+        pthread_mutex_destroy(&workers[i]->lock);
+        delete workers[i];
+    }
+}
+
+extern "C" void *
+workerThread(void *arg)
+{
+    WorkerPool::Worker *worker = (WorkerPool::Worker *)arg;
+
+    worker->pool->work(*worker);
+    return NULL;
+}
+
+void WorkerPool::work(Worker &worker)
+{
+    std::deque<WorkItem> items;
+
+    for (;;) {
+        pthread_mutex_lock(&worker.lock);
+        while (worker.queue.empty() && !worker.stopping) {
+            pthread_cond_wait(&worker.ready, &worker.lock);
+        }
+        if (worker.queue.empty()) {
+            /* Stopping, and nothing left to do. */
+            pthread_mutex_unlock(&worker.lock);
+            break;
+        }
+        /* Take everything queued so far and let the take thread go on. */
+        items.swap(worker.queue);
+        pthread_mutex_unlock(&worker.lock);
+
+        DDS::LongLong start = currentTimeNanos();
+        DDS::ULong done = items.size();
+        while (!items.empty()) {
+            spinNanos(workCost);
+            completion.record(currentTimeNanos() - items.front().sourceTime);
+            items.pop_front();
+        }
+
+        /* Only now are they done, and is there room for more. */
+        pthread_mutex_lock(&worker.lock);
+        worker.processed += done;
+        worker.busy += currentTimeNanos() - start;
+        worker.inFlight -= done;
+        pthread_cond_signal(&worker.space);
+        pthread_mutex_unlock(&worker.lock);
+    }
+}
+
+void WorkerPool::submit(const WorkItem &item)
+{
+    /* The same user always ends up with the same worker, which keeps its order. */
+    workers[(DDS::ULong)item.userID % workers.size()]->pending.push_back(item);
+}
+
+void WorkerPool::flush()
+{
+    for (DDS::ULong i = 0; i < workers.size(); i++) {
+        Worker &worker = *workers[i];
+
+        if (worker.pending.empty()) {
+            continue;
+        }
+        pthread_mutex_lock(&worker.lock);
+
+        /* Backpressure; a batch larger than the depth waits for an idle worker. */
+        if (worker.inFlight > 0 && worker.inFlight + worker.pending.size() > depth) {
+            waits++;
+            do {
+                pthread_cond_wait(&worker.space, &worker.lock);
+            } while (worker.inFlight > 0 && worker.inFlight + worker.pending.size() > depth);
+        }
+        bool wasEmpty = worker.queue.empty();
+        worker.inFlight += worker.pending.size();
+        worker.queue.insert(worker.queue.end(), worker.pending.begin(), worker.pending.end());
+        if (worker.queue.size() > worker.maxDepth) {
+            worker.maxDepth = worker.queue.size();
+        }
+        pthread_mutex_unlock(&worker.lock);
+
+        /* A worker that had items queued is not waiting. */
+        if (wasEmpty) {
+            pthread_cond_signal(&worker.ready);
+        }
+        worker.pending.clear();
+    }
+}
+
+bool WorkerPool::idle()
+{
+    bool result = true;
+
+    for (DDS::ULong i = 0; i < workers.size() && result; i++) {
+        Worker &worker = *workers[i];
+
+        pthread_mutex_lock(&worker.lock);
+        result = worker.pending.empty() && worker.inFlight == 0;
+        pthread_mutex_unlock(&worker.lock);
+    }
+    return result;
+}
+
+void WorkerPool::stop()
+{
+    if (!running) {
+        return;
+    }
+    running = false;
+    flush();
+    for (DDS::ULong i = 0; i < workers.size(); i++) {
+        pthread_mutex_lock(&workers[i]->lock);
+        workers[i]->stopping = true;
+        pthread_cond_signal(&workers[i]->ready);
+        pthread_mutex_unlock(&workers[i]->lock);
+    }
+    for (DDS::ULong i = 0; i < workers.size(); i++) {
+        pthread_join(workers[i]->thread, NULL);
+    }
+}
+
+void WorkerPool::report(std::ostream &out)
+{
+    out << "Worker pool: " << workers.size() << " threads, "
+        << fixed << setprecision(1) << workCost / 1000.0 << " us of work per message, "
+        << "at most " << depth << " items per worker, " << waits << " waits for room" << endl;
+    for (DDS::ULong i = 0; i < workers.size(); i++) {
+        Worker &worker = *workers[i];
+
+        pthread_mutex_lock(&worker.lock);
+        out << "  worker " << worker.id << ": " << worker.processed << " messages, "
+            << "deepest queue " << worker.maxDepth << ", busy "
+            << setprecision(3) << nanosToSeconds(worker.busy) << " s" << endl;
+        pthread_mutex_unlock(&worker.lock);
+    }
+}
@@ -0,0 +1,103 @@
+/************************************************************************
+ * LOGICAL_NAME:    WorkerPool.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for the pool of threads that process the
+ * messages taken by the MessageBoard.
+ * 
+ ***/
+
+#ifndef __WORKERPOOL_H__
+#define __WORKERPOOL_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <pthread.h>
+
+#include "ccpp_dds_dcps.h"
+#include "Histogram.h"
+
+/**
+ * A message copied out of the loan, so the loan can be returned right away.
+ **/
+struct WorkItem {
+    DDS::Long                           userID;
+    DDS::Long                           index;
+    DDS::LongLong                       sourceTime;     /* ns */
+    std::string                         content;
+};
+
+/* Thread entry point, with the C linkage pthread_create expects. */
+extern "C" void *workerThread(void *arg);
+
+/**
+ * Processes messages on a fixed number of threads. Every thread has its own
+ * queue and the queue is chosen by hashing the userID, so the messages of
+ * one user are processed by one thread in the order they were taken. The
+ * take thread collects the items of a batch per queue and hands them over
+ * in one go (one lock per queue per batch); a worker empties its whole
+ * queue at once as well. A worker holds at most a fixed number of items,
+ * queued or being processed: handing over more makes the take thread wait,
+ * so a slow worker slows down the taking instead of growing its queue.
+ **/
+class WorkerPool {
+
+    struct Worker {
+        WorkerPool                      *pool;
+        DDS::ULong                      id;
+        pthread_t                       thread;
+        pthread_mutex_t                 lock;
+        pthread_cond_t                  ready;
+        pthread_cond_t                  space;          /* inFlight went down */
+        std::deque<WorkItem>            queue;          /* guarded by lock */
+        DDS::ULong                      inFlight;       /* queued or being processed, guarded by lock */
+        std::vector<WorkItem>           pending;        /* take thread only */
+        bool                            stopping;       /* guarded by lock */
+        DDS::ULongLong                  processed;
+        DDS::ULong                      maxDepth;
+        DDS::LongLong                   busy;           /* ns spent processing */
+    };
+
+    std::vector<Worker *>               workers;
+    DDS::LongLong                       workCost;       /* ns of synthetic work per message */
+    Histogram                           &completion;    /* latency until processed */
+    DDS::ULong                          depth;          /* items a worker may hold */
+    DDS::ULongLong                      waits;          /* hand-overs that had to wait */
+    bool                                running;
+
+    friend void *workerThread(void *arg);
+
+    /* Process the items of one worker until it is stopped and its queue is empty. */
+    void work(Worker &worker);
+
+public:
+    /* Constructor: starts the given number of threads, each holding at most depth items. */
+    WorkerPool(DDS::ULong threads, DDS::ULong depth, DDS::LongLong workCost, Histogram &completion);
+
+    /* Destructor: stops the threads (after they have emptied their queues). */
+    ~WorkerPool();
+
+    /* Add a message to the batch of the worker of its user; the take thread only. */
+    void submit(const WorkItem &item);
+
+    /* Hand the batch collected by submit over to the workers, waiting for
+       room in their queues. */
+    void flush();
+
+    /* Returns whether every item handed over has been processed. */
+    bool idle();
+
+    /* Process everything that was handed over and stop the threads. */
+    void stop();
+
+    /* Print the messages processed and the deepest queue per worker, and how
+       often the take thread had to wait. */
+    void report(std::ostream &out);
+};
+
+#endif
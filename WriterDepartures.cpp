@@ -0,0 +1,116 @@
+/************************************************************************
+ * LOGICAL_NAME:    WriterDepartures.cpp
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the implementation for finding out exactly which
+ * users left, from the writers that lost their liveliness.
+ * 
+ ***/
+
+#include <algorithm>
+
+#include "WriterDepartures.h"
+#include "CheckStatus.h"
+
+WriterDepartures::WriterDepartures(
+    StatusMonitor &monitor
+) : StatusReaderListener(monitor), unattributed(0), unknownWriters(0)
+{
+    writersLost = new DDS::GuardCondition();
+    pthread_mutex_init(&lock, NULL);
+}
+
+WriterDepartures::~WriterDepartures()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+DDS::GuardCondition_ptr WriterDepartures::getCondition()
+{
+    return writersLost.in();
+}
+
+void WriterDepartures::userSeen(DDS::InstanceHandle_t publication, DDS::Long userID)
+{
+    WriterMap::iterator writer = writerOf.find(userID);
+
+    if (writer != writerOf.end()) {
+        if (writer->second == publication) {
+            return;
+        }
+        /* Another writer took over the user, e.g. after a restart. */
+        UserMap::iterator previous = usersOf.find(writer->second);
+        if (previous != usersOf.end()) {
+            std::vector<DDS::Long> &users = previous->second;
+            users.erase(std::remove(users.begin(), users.end(), userID), users.end());
+            if (users.empty()) {
+                usersOf.erase(previous);
+            }
+        }
+    }
+    writerOf[userID] = publication;
+    usersOf[publication].push_back(userID);
+}
+
+void WriterDepartures::departedUsers(std::vector<DDS::Long> &users)
+{
+    std::vector<DDS::InstanceHandle_t> writers;
+    DDS::ReturnCode_t status;
+
+    pthread_mutex_lock(&lock);
+    writers.swap(lost);
+    status = writersLost->set_trigger_value(FALSE);
+    checkStatus(status, "DDS::GuardCondition::set_trigger_value");
+    pthread_mutex_unlock(&lock);
+
+    for (DDS::ULong i = 0; i < writers.size(); i++) {
+        UserMap::iterator writer = usersOf.find(writers[i]);
+
+        if (writer == usersOf.end()) {
+            unknownWriters++;
+            continue;
+        }
+        for (DDS::ULong u = 0; u < writer->second.size(); u++) {
+            users.push_back(writer->second[u]);
+            writerOf.erase(writer->second[u]);
+        }
+        usersOf.erase(writer);
+    }
+}
+
+DDS::ULongLong WriterDepartures::getUnattributed()
+{
+    DDS::ULongLong result;
+
+    pthread_mutex_lock(&lock);
+    result = unattributed;
+    pthread_mutex_unlock(&lock);
+    return result;
+}
+
+DDS::ULongLong WriterDepartures::getUnknownWriters() const
+{
+    return unknownWriters;
+}
+
+void WriterDepartures::on_liveliness_changed (
+    DDS::DataReader_ptr reader,
+    const DDS::LivelinessChangedStatus & status
+) THROW_ORB_EXCEPTIONS {
+    DDS::ReturnCode_t result;
+
+    /* Writers coming alive, or going from not alive to deleted, are no departures. */
+    if (status.alive_count_change >= 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    lost.push_back(status.last_publication_handle);
+    unattributed += -status.alive_count_change - 1;
+    result = writersLost->set_trigger_value(TRUE);
+    checkStatus(result, "DDS::GuardCondition::set_trigger_value");
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,77 @@
+/************************************************************************
+ * LOGICAL_NAME:    WriterDepartures.h
+ * FUNCTION:        OpenSplice Tutorial example code.
+ * MODULE:          Tutorial for the C++ programming language.
+ * DATE             october 2026.
+ ************************************************************************
+ * 
+ * This file contains the headers for finding out exactly which users left,
+ * from the writers that lost their liveliness.
+ * 
+ ***/
+
+#ifndef __WRITERDEPARTURES_H__
+#define __WRITERDEPARTURES_H__
+
+#include <vector>
+#include <tr1/unordered_map>
+#include <pthread.h>
+
+#include "ccpp_dds_dcps.h"
+#include "orb_abstraction.h"
+#include "StatusMonitor.h"
+
+/**
+ * DataReaderListener for the ChatMessage reader of the UserLoad. Every
+ * sample carries the publication handle of its writer, so the users are
+ * mapped to their writers as their messages arrive, and moved when another
+ * writer takes a user over. Every liveliness
+ * change that takes a writer away is queued with its handle, and a
+ * GuardCondition wakes the WaitSet; the users of the writer then left,
+ * without a look at any other user. The listener is called once per
+ * change, so several users leaving between two wake-ups are all seen,
+ * unless the service already folded their changes into one; those are
+ * counted as unattributed.
+ **/
+class WriterDepartures : public StatusReaderListener {
+
+    typedef std::tr1::unordered_map<DDS::InstanceHandle_t, std::vector<DDS::Long> > UserMap;
+    typedef std::tr1::unordered_map<DDS::Long, DDS::InstanceHandle_t> WriterMap;
+
+    DDS::GuardCondition_var             writersLost;    /* triggered while lost is not empty */
+    std::vector<DDS::InstanceHandle_t>  lost;           /* queued by the listener */
+    DDS::ULongLong                      unattributed;   /* changes folded into another */
+    pthread_mutex_t                     lock;           /* for the three above */
+
+    UserMap                             usersOf;        /* per writer, used by the main thread only */
+    WriterMap                           writerOf;       /* per user, used by the main thread only */
+    DDS::ULongLong                      unknownWriters; /* lost before any message was seen */
+
+public:
+    /* Constructor */
+    WriterDepartures(StatusMonitor &monitor);
+
+    /* Destructor */
+    virtual ~WriterDepartures();
+
+    /* Returns the condition that triggers when writers were lost; owned by this object. */
+    DDS::GuardCondition_ptr getCondition();
+
+    /* Remember the writer of a user; cheap when it is unchanged, so call it for every sample. */
+    void userSeen(DDS::InstanceHandle_t publication, DDS::Long userID);
+
+    /* Append the users of the writers lost since the previous call, and forget them. */
+    void departedUsers(std::vector<DDS::Long> &users);
+
+    /* Returns the numbers of lost writers that could not be mapped onto users. */
+    DDS::ULongLong getUnattributed();
+    DDS::ULongLong getUnknownWriters() const;
+
+    /* Callback method implementation. */
+    virtual void on_liveliness_changed (
+        DDS::DataReader_ptr reader,
+        const DDS::LivelinessChangedStatus & status
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+#endif
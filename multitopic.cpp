@@ -24,41 +24,122 @@
 
 #include "multitopic.h"
 #include "CheckStatus.h"
+#include "Timing.h"
 #include <sstream>
+#include <iomanip>
+#include <cstring>
 
-DDS::DataReaderListenerImpl::DataReaderListenerImpl() : previous(0x80000000) {
+/* One in this many joined messages has the length of its strings measured. */
+#define COPY_SAMPLING 64
+
+DDS::NameCache::NameCache(
+    StatusMonitor &monitor
+) : StatusReaderListener(monitor), hits(0), misses(0), evictions(0) {
+    pthread_mutex_init(&lock, NULL);
+}
+
+DDS::NameCache::~NameCache() {
+    pthread_mutex_destroy(&lock);
+}
+
+bool DDS::NameCache::lookup(Long userID, std::string &name) {
+    bool found;
+
+    pthread_mutex_lock(&lock);
+    NameMap::iterator entry = names.find(userID);
+    found = entry != names.end();
+    if (found) {
+        name = entry->second;
+        hits++;
+    } else {
+        misses++;
+    }
+    pthread_mutex_unlock(&lock);
+    return found;
+}
+
+void DDS::NameCache::remember(Long userID, const std::string &name) {
+    pthread_mutex_lock(&lock);
+    names[userID] = name;
+    pthread_mutex_unlock(&lock);
+}
+
+void DDS::NameCache::report(std::ostream &out) {
+    pthread_mutex_lock(&lock);
+    out << "Name cache: " << names.size() << " names, " << hits << " hits, "
+        << misses << " misses, " << evictions << " evictions" << endl;
+    pthread_mutex_unlock(&lock);
+}
+
+void DDS::NameCache::on_data_available (
+    DDS::DataReader_ptr reader
+) THROW_ORB_EXCEPTIONS {
+    Chat::NameServiceDataReader_var     nameServiceDR;
+    Chat::NameService                   key;
+    DDS::ReturnCode_t                   status;
+
+    nameServiceDR = Chat::NameServiceDataReader::_narrow(reader);
+    checkHandle(nameServiceDR.in(), "Chat::NameServiceDataReader::_narrow");
+
+    pthread_mutex_lock(&lock);
+
+    /* Read, not take: the names stay in the reader for the lookups that miss. */
+    status = nameServiceDR->read( 
+        nameSeq, 
+        infoSeq, 
+        DDS::LENGTH_UNLIMITED, 
+        DDS::NOT_READ_SAMPLE_STATE, 
+        DDS::ANY_VIEW_STATE, 
+        DDS::ANY_INSTANCE_STATE);
+    checkStatus(status, "Chat::NameServiceDataReader::read");
+    for (ULong i = 0; i < nameSeq.length(); i++) {
+        if (infoSeq[i].instance_state == DDS::ALIVE_INSTANCE_STATE) {
+            if (infoSeq[i].valid_data) {
+                names[nameSeq[i].userID] = nameSeq[i].name.in();
+            }
+        } else {
+            /* Disposed or without writers: the user left. */
+            status = nameServiceDR->get_key_value(key, infoSeq[i].instance_handle);
+            checkStatus(status, "Chat::NameServiceDataReader::get_key_value");
+            evictions += names.erase(key.userID);
+        }
+    }
+    status = nameServiceDR->return_loan(nameSeq, infoSeq);
+    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+
+    pthread_mutex_unlock(&lock);
+}
+
+DDS::DataReaderListenerImpl::DataReaderListenerImpl(
+    StatusMonitor &monitor,
+    CycleProfile &profile
+) : StatusReaderListener(monitor), previous(0x80000000), joined(0), copies(0),
+    bytesCopied(0), misses(0), sampled(0), sampledBytes(0), profile(profile), nameCache(NULL) {
     nameFinderParams.length(1);
+    joinPhase = profile.addPhase("on_data_available");
+    pthread_mutex_init(&copyLock, NULL);
 }
 
-void DDS::DataReaderListenerImpl::on_requested_deadline_missed (
-    DDS::DataReader_ptr reader,
-    const DDS::RequestedDeadlineMissedStatus & status
-) THROW_ORB_EXCEPTIONS { }
-
-void DDS::DataReaderListenerImpl::on_requested_incompatible_qos (
-    DDS::DataReader_ptr reader,
-    const DDS::RequestedIncompatibleQosStatus & status
-) THROW_ORB_EXCEPTIONS { }
-
-void DDS::DataReaderListenerImpl::on_sample_rejected (
-    DDS::DataReader_ptr reader,
-    const DDS::SampleRejectedStatus & status
-) THROW_ORB_EXCEPTIONS { }
-
-void DDS::DataReaderListenerImpl::on_liveliness_changed (
-    DDS::DataReader_ptr reader,
-    const DDS::LivelinessChangedStatus & status
-) THROW_ORB_EXCEPTIONS { }
-
-void DDS::DataReaderListenerImpl::on_subscription_matched (
-    DDS::DataReader_ptr reader,
-    const DDS::SubscriptionMatchedStatus & status
-) THROW_ORB_EXCEPTIONS { }
-                                    
-void DDS::DataReaderListenerImpl::on_sample_lost (
-    DDS::DataReader_ptr reader,
-    const DDS::SampleLostStatus & status
-) THROW_ORB_EXCEPTIONS { }
+DDS::DataReaderListenerImpl::~DataReaderListenerImpl() {
+    pthread_mutex_destroy(&copyLock);
+}
+
+void DDS::DataReaderListenerImpl::report(std::ostream &out) {
+    pthread_mutex_lock(&copyLock);
+    double messages = joined > 0 ? joined : 1;
+
+    out << "Join copies: " << joined << " messages, " << std::fixed << std::setprecision(3)
+        << copies / messages << " strings and " << std::setprecision(1)
+        << bytesCopied / messages << " bytes copied per message, " << misses
+        << " names looked up in the reader";
+    if (sampled > 0) {
+        /* Duplicating meant a string_dup of the name and of the content. */
+        out << " (duplicating both strings: about " << (double)sampledBytes / sampled
+            << " bytes per message)";
+    }
+    out << endl;
+    pthread_mutex_unlock(&copyLock);
+}
 
 void DDS::DataReaderListenerImpl::on_data_available (
     DDS::DataReader_ptr reader
@@ -68,6 +149,15 @@ void DDS::DataReaderListenerImpl::on_data_available (
     DDS::SampleInfoSeq                  infoSeq1;
     DDS::SampleInfoSeq                  infoSeq2;
     DDS::ReturnCode_t                   status;
+    DDS::ULongLong                      start = readCycles();
+    ULong                               taken;
+    ULong                               written = 0;
+    ULong                               copied = 0;
+    ULong                               missed = 0;
+    ULong                               measured = 0;
+    DDS::ULongLong                      bytes = 0;
+    DDS::ULongLong                      measuredBytes = 0;
+    DDS::ULongLong                      next;
     previous =                          0x80000000;
     
     /* Take all messages. */
@@ -79,57 +169,107 @@ void DDS::DataReaderListenerImpl::on_data_available (
         DDS::ANY_VIEW_STATE, 
         DDS::ANY_INSTANCE_STATE);
     checkStatus(status, "Chat::ChatMessageDataReader::take");
+    taken = msgSeq.length();
+
+    /* Where the sampling of the string lengths goes on from the previous call. */
+    pthread_mutex_lock(&copyLock);
+    next = joined;
+    pthread_mutex_unlock(&copyLock);
     
     /* For each message, extract the key-field and find the corresponding name. */
     for (ULong i = 0; i < msgSeq.length(); i++)
     {
         if (infoSeq1[i].valid_data)
         {
-            Chat::NamedMessage joinedSample;
-        
-            /* Find the corresponding named message. */
+            /* Find the corresponding named message, in the cache if possible. */
             if (msgSeq[i].userID != previous)
             {
-                ostringstream numberStr;
                 previous = msgSeq[i].userID;
-                numberStr << previous;
-                nameFinderParams[0UL] = numberStr.str().c_str();
-                status = nameFinder->set_query_parameters(nameFinderParams);
-                checkStatus(status, "DDS::QueryCondition::set_query_parameters");
-                status = nameServiceDR->read_w_condition( 
-                    nameSeq, 
-                    infoSeq2, 
-                    DDS::LENGTH_UNLIMITED, 
-                    nameFinder.in());
-                checkStatus(status, "Chat::NameServiceDataReader::read_w_condition");
-                
-                /* Extract Name (there should only be one result). */
-                if (status == DDS::RETCODE_NO_DATA)
+                if (!nameCache->lookup(previous, userName))
                 {
-                    ostringstream msg;
-                    msg << "Name not found!! id = " << previous;
-                    userName = msg.str();
-                }
-                else
-                {
-                    userName = nameSeq[0].name;
+                    ostringstream numberStr;
+
+                    /* The query parameter is a copy of the userID as a string. */
+                    missed++;
+                    numberStr << previous;
+                    nameFinderParams[0UL] = numberStr.str().c_str();
+                    copied++;
+                    bytes += strlen(nameFinderParams[0UL]) + 1;
+                    status = nameFinder->set_query_parameters(nameFinderParams);
+                    checkStatus(status, "DDS::QueryCondition::set_query_parameters");
+                    status = nameServiceDR->read_w_condition( 
+                        nameSeq, 
+                        infoSeq2, 
+                        DDS::LENGTH_UNLIMITED, 
+                        nameFinder.in());
+                    checkStatus(status, "Chat::NameServiceDataReader::read_w_condition");
+                    
+                    /* Extract Name (there should only be one result). */
+                    if (status == DDS::RETCODE_NO_DATA)
+                    {
+                        ostringstream msg;
+                        msg << "Name not found!! id = " << previous;
+                        userName = msg.str();
+                    }
+                    else
+                    {
+                        userName = nameSeq[0].name;
+                        if (infoSeq2[0].instance_state == DDS::ALIVE_INSTANCE_STATE)
+                        {
+                            nameCache->remember(previous, userName);
+                        }
+                    }
+        
+                    /* Release the name sample again. */                
+                    status = nameServiceDR->return_loan(nameSeq, infoSeq2);
+                    checkStatus(status, "Chat::NameServiceDataReader::return_loan");
                 }
-    
-                /* Release the name sample again. */                
-                status = nameServiceDR->return_loan(nameSeq, infoSeq2);
-                checkStatus(status, "Chat::NameServiceDataReader::return_loan");
+                /* Otherwise only the name is copied, once per change of user. */
+                copied++;
+                bytes += userName.size() + 1;
             }
-            /* Write merged Topic with userName instead of userID. */
-            joinedSample.userName = userName.c_str();
+            /* Write merged Topic with userName instead of userID. Keep the
+               source timestamp of the ChatMessage, so that readers of the
+               NamedMessage can tell the latency from the original write.
+               The name and the content are lent to the sample instead of
+               duplicated: the write copies them into the writer anyway, and
+               they are taken back before anything could free them. */
+            joinedSample.userName = const_cast<char *>(userName.c_str());
             joinedSample.userID = msgSeq[i].userID;
             joinedSample.index = msgSeq[i].index;
-            joinedSample.content = msgSeq[i].content;
-            status = namedMessageDW->write(joinedSample, DDS::HANDLE_NIL);
-            checkStatus(status, "Chat::NamedMessageDataWriter::write");
+            joinedSample.content = const_cast<char *>(msgSeq[i].content.in());
+            status = namedMessageDW->write_w_timestamp(
+                joinedSample, 
+                DDS::HANDLE_NIL, 
+                infoSeq1[i].source_timestamp);
+            joinedSample.userName._retn();
+            joinedSample.content._retn();
+            checkStatus(status, "Chat::NamedMessageDataWriter::write_w_timestamp");
+
+            /* Measuring every content would be a pass over every payload. */
+            if ((next + written) % COPY_SAMPLING == 0)
+            {
+                measured++;
+                measuredBytes += userName.size() + strlen(msgSeq[i].content.in()) + 2;
+            }
+            written++;
         }
     }
     status = chatMessageDR->return_loan(msgSeq, infoSeq1);
     checkStatus(status, "Chat::ChatMessageDataReader::return_loan");
+
+    /* Once per callback, so the report can read them consistently. */
+    pthread_mutex_lock(&copyLock);
+    joined += written;
+    copies += copied;
+    bytesCopied += bytes;
+    misses += missed;
+    sampled += measured;
+    sampledBytes += measuredBytes;
+    pthread_mutex_unlock(&copyLock);
+
+    /* The whole callback: take, name lookups, writes and return_loan. */
+    profile.record(joinPhase, readCycles() - start, taken);
 }
 
 
@@ -142,7 +282,9 @@ DDS::DomainParticipant_ptr DDS::ExtDomainParticipantImpl::in() {
 }
 
 
-DDS::ExtDomainParticipantImpl::ExtDomainParticipantImpl(DDS::DomainParticipant_ptr participant) {
+DDS::ExtDomainParticipantImpl::ExtDomainParticipantImpl(
+    DDS::DomainParticipant_ptr participant
+) : multitopicProfile("Multitopic") {
     realParticipant = DDS::DomainParticipant::_duplicate(participant);
 }
 
@@ -214,19 +356,28 @@ DDS::ExtDomainParticipantImpl::create_simulated_multitopic (
     checkHandle(chatMessageDR, "Chat::ChatMessageDataReader::_narrow");
     
     /* Allocate the DataReaderListener Implementation. */
-    msgListener = new DDS::DataReaderListenerImpl();
+    msgListener = new DDS::DataReaderListenerImpl(multitopicStatus, multitopicProfile);
     checkHandle(msgListener, "new DDS::DataReaderListenerImpl");
     
-    /* Attach the DataReaderListener to the DataReader, only enabling the data_available event. */
-    status = chatMessageDR->set_listener(msgListener, DDS::DATA_AVAILABLE_STATUS);
+    /* Allocate the Listener that keeps the names, before any message can arrive. */
+    nameCache = new DDS::NameCache(multitopicStatus);
+    checkHandle(nameCache, "new DDS::NameCache");
+    msgListener->nameCache = nameCache;
+
+    /* Attach the DataReaderListener to the DataReader, for the data_available event and the monitored statuses. */
+    status = chatMessageDR->set_listener(msgListener, DDS::DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
     checkStatus(status, "DDS::DataReader_set_listener");
 
+    /* Allocate the Listener that only counts the monitored statuses. */
+    namedStatusListener = new StatusWriterListener(multitopicStatus);
+    checkHandle(namedStatusListener, "new StatusWriterListener");
+
     /* Create a DataReader for the nameService Topic (using the appropriate QoS). */
     parentReader = multiSub->create_datareader( 
         nameServiceTopic.in(), 
         DATAREADER_QOS_USE_TOPIC_QOS, 
-        NULL,
-        DDS::STATUS_MASK_NONE);
+        nameCache,
+        DDS::DATA_AVAILABLE_STATUS | MONITORED_READER_STATUS);
     checkHandle(parentReader, "DDS::Subscriber::create_datareader (NameService)");
     
     /* Narrow the abstract parent into its typed representative. */
@@ -272,8 +423,8 @@ DDS::ExtDomainParticipantImpl::create_simulated_multitopic (
     parentWriter = multiPub->create_datawriter( 
         namedMessageTopic.in(), 
         DATAWRITER_QOS_USE_TOPIC_QOS, 
-        NULL,
-        DDS::STATUS_MASK_NONE);
+        namedStatusListener,
+        MONITORED_WRITER_STATUS);
     checkHandle(parentWriter, "DDS::Publisher::create_datawriter (NamedMessage)");
     
     /* Narrow the abstract parent into its typed representative. */
@@ -316,8 +467,10 @@ DDS::ExtDomainParticipantImpl::delete_simulated_multitopic(
     status = multiSub->delete_datareader(msgListener->chatMessageDR.in());
     checkStatus(status, "DDS::Subscriber::delete_datareader");
 
-    /* Remove the DataReaderListener. */
+    /* Remove the Listeners. */
     DDS::release(msgListener);
+    DDS::release(nameCache);
+    DDS::release(namedStatusListener);
 
     /* Remove the Subscriber. */
     status = realParticipant->delete_subscriber(multiSub.in());
@@ -340,6 +493,30 @@ DDS::ExtDomainParticipantImpl::delete_simulated_multitopic(
 
 
 
+StatusMonitor &
+DDS::ExtDomainParticipantImpl::get_simulated_multitopic_status()
+{
+    return multitopicStatus;
+}
+
+CycleProfile &
+DDS::ExtDomainParticipantImpl::get_simulated_multitopic_profile()
+{
+    return multitopicProfile;
+}
+
+DDS::NameCache &
+DDS::ExtDomainParticipantImpl::get_simulated_multitopic_names()
+{
+    return *nameCache;
+}
+
+void
+DDS::ExtDomainParticipantImpl::report_simulated_multitopic_copies(std::ostream &out)
+{
+    msgListener->report(out);
+}
+
 DDS::ReturnCode_t DDS::ExtDomainParticipantImpl::enable (
 ) THROW_ORB_EXCEPTIONS {
     return realParticipant->enable();
@@ -23,68 +23,111 @@
  ***/
 
 #include <string>
+#include <iostream>
+#include <tr1/unordered_map>
+#include <pthread.h>
 
 #include "ccpp_dds_dcps.h"
 #include "ccpp_Chat.h"
 #include "orb_abstraction.h"
+#include "StatusMonitor.h"
+#include "CycleProfile.h"
 
 
 namespace DDS {
-    
-class DataReaderListenerImpl : public virtual DDS::DataReaderListener {
+
+/**
+ * The names of the users by userID, kept by the listener of the NameService
+ * reader as names arrive and dropped when their instance is disposed or
+ * loses its writers, so the join looks a name up without any DDS call. The
+ * join falls back to the reader itself on a miss, e.g. for a name that was
+ * dropped while its last messages were underway; the hits and misses are
+ * counted.
+ **/
+class NameCache : public StatusReaderListener {
+
+    typedef std::tr1::unordered_map<Long, std::string> NameMap;
+
+    NameMap                             names;
+    DDS::ULongLong                      hits;
+    DDS::ULongLong                      misses;
+    DDS::ULongLong                      evictions;
+    Chat::NameServiceSeq                nameSeq;
+    DDS::SampleInfoSeq                  infoSeq;
+    pthread_mutex_t                     lock;
+
+public:
+    /* Constructor */
+    NameCache(StatusMonitor &monitor);
+
+    /* Destructor */
+    virtual ~NameCache();
+
+    /* Find the name of a user, returns false on a miss. */
+    bool lookup(Long userID, std::string &name);
+
+    /* Add a name found in the reader on a miss; the lookup marked it read,
+       so the listener will not see it. */
+    void remember(Long userID, const std::string &name);
+
+    /* Print the number of names and the hits and misses of the lookups. */
+    void report(std::ostream &out);
+
+    /* Callback method implementation. */
+    virtual void on_data_available (
+        DDS::DataReader_ptr reader
+    ) THROW_ORB_EXCEPTIONS;
+};
+
+class DataReaderListenerImpl : public StatusReaderListener {
 
     /* Caching variables */
     Long                                previous;
     std::string                         userName;
 
+    /* The sample every join is written from; its strings are only lent. */
+    Chat::NamedMessage                  joinedSample;
+
+    /* What the joins copied, and a sample of the strings they lent, from
+       which duplicating both strings per message is estimated. */
+    DDS::ULongLong                      joined;
+    DDS::ULongLong                      copies;         /* strings copied by the join */
+    DDS::ULongLong                      bytesCopied;
+    DDS::ULongLong                      misses;         /* names looked up in the reader */
+    DDS::ULongLong                      sampled;        /* messages whose strings were measured */
+    DDS::ULongLong                      sampledBytes;
+    pthread_mutex_t                     copyLock;       /* for the counters above */
+
+    /* Cycles per sample spent in on_data_available. */
+    CycleProfile                        &profile;
+    DDS::ULong                          joinPhase;
+
 public:
     /* Type-specific DDS entities */
     Chat::ChatMessageDataReader_var     chatMessageDR;
     Chat::NameServiceDataReader_var     nameServiceDR;
     Chat::NamedMessageDataWriter_var    namedMessageDW;
 
-    /* Query related stuff */
+    /* Query related stuff, for the names that are not in the cache */
     DDS::QueryCondition_var             nameFinder;
     DDS::StringSeq                      nameFinderParams;
+    NameCache                           *nameCache;
     
     
     /* Constructor */
-    DataReaderListenerImpl();
-    
-    /* Callback method implementation. */    
-    virtual void on_requested_deadline_missed (
-        DDS::DataReader_ptr reader,
-        const DDS::RequestedDeadlineMissedStatus & status
-    ) THROW_ORB_EXCEPTIONS;
+    DataReaderListenerImpl(StatusMonitor &monitor, CycleProfile &profile);
 
-    virtual void on_requested_incompatible_qos (
-        DDS::DataReader_ptr reader,
-        const DDS::RequestedIncompatibleQosStatus & status
-    ) THROW_ORB_EXCEPTIONS;
-
-    virtual void on_sample_rejected (
-        DDS::DataReader_ptr reader,
-        const DDS::SampleRejectedStatus & status
-    ) THROW_ORB_EXCEPTIONS;
-
-    virtual void on_liveliness_changed (
-        DDS::DataReader_ptr reader,
-        const DDS::LivelinessChangedStatus & status
-    ) THROW_ORB_EXCEPTIONS;
+    /* Destructor */
+    virtual ~DataReaderListenerImpl();
 
+    /* Print the strings and bytes copied per joined message, against the
+       estimated bytes of duplicating the name and content into every sample. */
+    void report(std::ostream &out);
+    
+    /* Callback method implementation. */    
     virtual void on_data_available (
         DDS::DataReader_ptr reader
     ) THROW_ORB_EXCEPTIONS;
-
-    virtual void on_subscription_matched (
-        DDS::DataReader_ptr reader,
-        const DDS::SubscriptionMatchedStatus & status
-    ) THROW_ORB_EXCEPTIONS;
-                   
-    virtual void on_sample_lost (
-        DDS::DataReader_ptr reader,
-        const DDS::SampleLostStatus & status
-    ) THROW_ORB_EXCEPTIONS;
 };
 
 class ExtDomainParticipantImpl;
@@ -117,6 +160,12 @@ class ExtDomainParticipantImpl
     /*Implementation for DataReaderListener */
     DDS::DataReaderListenerImpl         *msgListener;
 
+    /* Statuses of the Readers and Writer of the multitopic simulator. */
+    StatusMonitor                       multitopicStatus;
+    NameCache                           *nameCache;
+    StatusWriterListener                *namedStatusListener;
+    CycleProfile                        multitopicProfile;
+
     /* Generic DDS entities */
     DDS::Topic_var                      chatMessageTopic;
     DDS::Topic_var                      nameServiceTopic;
@@ -151,6 +200,18 @@ public:
     virtual DDS::ReturnCode_t delete_simulated_multitopic (
         DDS::TopicDescription_ptr a_topic
     );
+
+    // The lost and rejected samples etc. of the multitopic simulator.
+    StatusMonitor & get_simulated_multitopic_status ();
+
+    // The cycles per sample the multitopic simulator spends joining.
+    CycleProfile & get_simulated_multitopic_profile ();
+
+    // The names the multitopic simulator joins with.
+    NameCache & get_simulated_multitopic_names ();
+
+    // The copies the multitopic simulator makes per joined message.
+    void report_simulated_multitopic_copies (std::ostream &out);
     
     virtual DDS::ReturnCode_t enable (
     ) THROW_ORB_EXCEPTIONS;